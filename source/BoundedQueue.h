@@ -0,0 +1,74 @@
+//  This file is part of PuzzleEngine, https://github.com/mercere99/PuzzleEngine/
+//  Copyright (C) Michigan State University, 2015.
+//  Released under the MIT Software license; see doc/LICENSE
+//
+//
+//  A blocking queue with a fixed capacity, for connecting the stages of a pipeline.
+//
+//  Push() waits while the queue is full, so a fast stage can't run arbitrarily far ahead
+//  of a slow one; Pop() waits while it is empty.  Once the producers are finished, Close()
+//  lets consumers drain what is left, after which Pop() returns false.
+
+#ifndef PZE_BOUNDED_QUEUE_H
+#define PZE_BOUNDED_QUEUE_H
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+namespace pze {
+
+  template <typename T>
+  class BoundedQueue {
+  private:
+    std::deque<T> items;
+    size_t capacity;
+    bool closed;
+
+    std::mutex mutex;
+    std::condition_variable not_full;
+    std::condition_variable not_empty;
+
+  public:
+    BoundedQueue(size_t in_capacity) : capacity(in_capacity), closed(false) { ; }
+    BoundedQueue(const BoundedQueue &) = delete;
+    ~BoundedQueue() { ; }
+    BoundedQueue & operator=(const BoundedQueue &) = delete;
+
+    // Add an item, waiting for room; return false (dropping the item) if the queue is closed.
+    bool Push(T item) {
+      std::unique_lock<std::mutex> lock(mutex);
+      not_full.wait(lock, [this]{ return closed || items.size() < capacity; });
+      if (closed) return false;
+      items.push_back(std::move(item));
+      lock.unlock();
+      not_empty.notify_one();
+      return true;
+    }
+
+    // Take the oldest item, waiting for one; return false once the queue is closed and empty.
+    bool Pop(T & item) {
+      std::unique_lock<std::mutex> lock(mutex);
+      not_empty.wait(lock, [this]{ return closed || !items.empty(); });
+      if (items.empty()) return false;
+      item = std::move(items.front());
+      items.pop_front();
+      lock.unlock();
+      not_full.notify_one();
+      return true;
+    }
+
+    // No more items will be pushed; wake everyone waiting.
+    void Close() {
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        closed = true;
+      }
+      not_full.notify_all();
+      not_empty.notify_all();
+    }
+  };
+
+}
+
+#endif
@@ -0,0 +1,93 @@
+//  This file is part of PuzzleEngine, https://github.com/mercere99/PuzzleEngine/
+//  Copyright (C) Michigan State University, 2015.
+//  Released under the MIT Software license; see doc/LICENSE
+//
+//
+//  A CellMask is a fixed-size set of up to 128 cell ids, stored as two 64-bit words.
+//  It is big enough to hold one bit per cell for a 9x9 board (81 cells) and is
+//  cheap to copy, combine, and iterate in id order.
+//
+
+#ifndef PZE_CELL_MASK_H
+#define PZE_CELL_MASK_H
+
+#include <cstdint>
+
+namespace pze {
+
+  class CellMask {
+  private:
+    uint64_t lo;   // Cells 0-63
+    uint64_t hi;   // Cells 64-127
+
+  public:
+    constexpr CellMask() : lo(0), hi(0) { ; }
+    constexpr CellMask(uint64_t in_lo, uint64_t in_hi) : lo(in_lo), hi(in_hi) { ; }
+    constexpr CellMask(const CellMask &) = default;
+    constexpr CellMask & operator=(const CellMask &) = default;
+
+    // Build a mask with only the first num_cells bits turned on.
+    static constexpr CellMask Range(int num_cells) {
+      return CellMask( num_cells >= 64 ? ~0ull : ((1ull << num_cells) - 1),
+                       num_cells >= 128 ? ~0ull
+                       : (num_cells <= 64 ? 0ull : ((1ull << (num_cells - 64)) - 1)) );
+    }
+    static constexpr CellMask Single(int id) {
+      return id < 64 ? CellMask(1ull << id, 0) : CellMask(0, 1ull << (id - 64));
+    }
+
+    constexpr uint64_t GetLo() const { return lo; }
+    constexpr uint64_t GetHi() const { return hi; }
+
+    constexpr bool Has(int id) const {
+      return id < 64 ? (lo >> id) & 1 : (hi >> (id - 64)) & 1;
+    }
+    constexpr void Set(int id) {
+      if (id < 64) lo |= 1ull << id;
+      else hi |= 1ull << (id - 64);
+    }
+    constexpr void Clear(int id) {
+      if (id < 64) lo &= ~(1ull << id);
+      else hi &= ~(1ull << (id - 64));
+    }
+    constexpr void Clear() { lo = hi = 0; }
+
+    constexpr bool Any() const { return (lo | hi) != 0; }
+    constexpr bool None() const { return (lo | hi) == 0; }
+    int Count() const { return __builtin_popcountll(lo) + __builtin_popcountll(hi); }
+
+    // Return the lowest id in the mask (mask must not be empty).
+    int First() const { return lo ? __builtin_ctzll(lo) : 64 + __builtin_ctzll(hi); }
+
+    // Remove and return the lowest id in the mask (mask must not be empty).
+    int Pop() {
+      if (lo) { const int id = __builtin_ctzll(lo); lo &= lo - 1; return id; }
+      const int id = 64 + __builtin_ctzll(hi);
+      hi &= hi - 1;
+      return id;
+    }
+
+    // Call fun(id) for every id in the mask, in increasing order.
+    template <typename FUN_T>
+    void ForEach(FUN_T && fun) const {
+      for (uint64_t w = lo; w; w &= w - 1) fun(__builtin_ctzll(w));
+      for (uint64_t w = hi; w; w &= w - 1) fun(64 + __builtin_ctzll(w));
+    }
+
+    constexpr CellMask operator|(const CellMask & in) const { return CellMask(lo | in.lo, hi | in.hi); }
+    constexpr CellMask operator&(const CellMask & in) const { return CellMask(lo & in.lo, hi & in.hi); }
+    constexpr CellMask operator^(const CellMask & in) const { return CellMask(lo ^ in.lo, hi ^ in.hi); }
+    constexpr CellMask operator~() const { return CellMask(~lo, ~hi); }
+    constexpr CellMask & operator|=(const CellMask & in) { lo |= in.lo; hi |= in.hi; return *this; }
+    constexpr CellMask & operator&=(const CellMask & in) { lo &= in.lo; hi &= in.hi; return *this; }
+    constexpr CellMask & operator^=(const CellMask & in) { lo ^= in.lo; hi ^= in.hi; return *this; }
+    constexpr bool operator==(const CellMask & in) const { return lo == in.lo && hi == in.hi; }
+    constexpr bool operator!=(const CellMask & in) const { return !(*this == in); }
+
+    // Remove all ids in the provided mask.
+    constexpr CellMask & Remove(const CellMask & in) { lo &= ~in.lo; hi &= ~in.hi; return *this; }
+  };
+
+}
+
+#endif
@@ -0,0 +1,174 @@
+//  This file is part of PuzzleEngine, https://github.com/mercere99/PuzzleEngine/
+//  Copyright (C) Michigan State University, 2015.
+//  Released under the MIT Software license; see doc/LICENSE
+//
+//
+//  Island-model evolution: several populations that evolve independently, in parallel,
+//  and trade their best organisms every few generations.
+//
+//  Each island has its own population and its own emp::Random, seeded from the master
+//  random number generator when the islands are created.  Between migrations every island
+//  runs as a single ThreadPool task, so islands never wait on one another; migration is
+//  done serially.  The top organisms of each island replace the worst organisms of its
+//  neighbor: the next island around a fixed ring, or around a ring shuffled anew for each
+//  migration (drawn from a separate generator).  Either way every island receives exactly
+//  one group of migrants, so its best organisms are never replaced.  Given the same seed
+//  and number of islands, the results are the same however many threads the pool has.
+//
+//  How a generation is run is up to the caller: Run() takes a function that advances one
+//  island's population by a generation, using that island's random number generator.
+//  Since it runs inside a pool task, it must not submit work to the same pool.
+
+#ifndef PZE_ISLAND_MODEL_H
+#define PZE_ISLAND_MODEL_H
+
+#include <algorithm>
+#include <memory>
+#include <numeric>
+#include <vector>
+#include "base/assert.hpp"
+#include "math/Random.hpp"
+#include "Population.h"
+#include "ThreadPool.h"
+
+namespace pze {
+
+  template <typename ORG>
+  class IslandModel {
+  public:
+    using fit_fun_t = typename Population<ORG>::fit_fun_t;
+
+    enum class Topology { RING, RANDOM };
+
+  private:
+    struct Island {
+      Population<ORG> pop;
+      emp::Random random;
+      Island(int seed) : random(seed) { ; }
+    };
+
+    std::vector<std::unique_ptr<Island>> islands;
+    emp::Random migrate_random;         // Shuffles the ring for the random topology.
+    fit_fun_t fit_fun;
+    Topology topology;
+    int num_migrants;                   // Organisms sent from each island per migration.
+    int generation;
+
+    // Draw a positive seed for a new stream.
+    static int NextSeed(emp::Random & random) { return 1 + (int) (random.GetUInt() >> 2); }
+
+    // Ids of a population's organisms, best first (ties favor the earlier organism).
+    std::vector<int> RankIsland(Island & island) {
+      Population<ORG> & pop = island.pop;
+      std::vector<double> fitness(pop.GetSize());
+      std::vector<int> order(pop.GetSize());
+      for (int i = 0; i < pop.GetSize(); i++) fitness[i] = fit_fun(&pop[i]);
+      std::iota(order.begin(), order.end(), 0);
+      std::stable_sort(order.begin(), order.end(),
+                       [&fitness](int a, int b){ return fitness[a] > fitness[b]; });
+      return order;
+    }
+
+    // dest[i] is the island that island i sends to.  A random topology is a random cyclic
+    // permutation (Sattolo's algorithm), so no island sends to itself or receives twice.
+    std::vector<int> PickDestinations() {
+      const int num_islands = GetNumIslands();
+      std::vector<int> dest(num_islands);
+      for (int i = 0; i < num_islands; i++) dest[i] = (i + 1) % num_islands;
+      if (topology == Topology::RANDOM) {
+        std::iota(dest.begin(), dest.end(), 0);
+        for (int i = num_islands - 1; i > 0; i--) std::swap(dest[i], dest[migrate_random.GetUInt(i)]);
+      }
+      return dest;
+    }
+
+  public:
+    // Create num_islands islands, each with island_size copies of seed_org.
+    IslandModel(const ORG & seed_org, int num_islands, int island_size, emp::Random & random,
+                fit_fun_t in_fit_fun, Topology in_topology=Topology::RING, int in_num_migrants=1)
+      : migrate_random(NextSeed(random)), fit_fun(in_fit_fun), topology(in_topology)
+      , num_migrants(in_num_migrants), generation(0)
+    {
+      emp_assert(num_islands > 0 && island_size > num_migrants, num_islands, island_size, num_migrants);
+      for (int i = 0; i < num_islands; i++) {
+        islands.push_back(std::make_unique<Island>(NextSeed(random)));
+        islands.back()->pop.Insert(seed_org, island_size);
+      }
+    }
+    IslandModel(const IslandModel &) = delete;
+    ~IslandModel() { ; }
+    IslandModel & operator=(const IslandModel &) = delete;
+
+    int GetNumIslands() const { return (int) islands.size(); }
+    int GetGeneration() const { return generation; }
+    Population<ORG> & GetIsland(int id) { return islands[id]->pop; }
+    const Population<ORG> & GetIsland(int id) const { return islands[id]->pop; }
+
+    // Send each island's top organisms to its neighbor, replacing the neighbor's worst.
+    // All migrants are chosen before any are placed.
+    void Migrate() {
+      const int num_islands = GetNumIslands();
+      if (num_islands < 2 || num_migrants == 0) return;
+
+      std::vector<std::vector<int>> ranks(num_islands);
+      for (int i = 0; i < num_islands; i++) ranks[i] = RankIsland(*islands[i]);
+
+      const std::vector<int> dest = PickDestinations();
+      std::vector<std::vector<ORG>> incoming(num_islands);
+      for (int i = 0; i < num_islands; i++) {
+        for (int m = 0; m < num_migrants; m++) incoming[dest[i]].push_back(islands[i]->pop[ranks[i][m]]);
+      }
+
+      // Each island takes in num_migrants organisms, fewer than its size, so its best
+      // organism (rank 0) always survives.
+      for (int i = 0; i < num_islands; i++) {
+        Population<ORG> & pop = islands[i]->pop;
+        const std::vector<int> & rank = ranks[i];
+        const int num_in = std::min((int) incoming[i].size(), pop.GetSize() - 1);
+        for (int m = 0; m < num_in; m++) pop[rank[pop.GetSize() - 1 - m]] = incoming[i][m];
+      }
+    }
+
+    // Run num_gens generations on every island, migrating after every migrate_interval
+    // generations.  step_fun(pop, random) must advance a population by one generation.
+    template <typename STEP_FUN>
+    void Run(int num_gens, int migrate_interval, ThreadPool & pool, STEP_FUN && step_fun) {
+      emp_assert(migrate_interval > 0, migrate_interval);
+      int remaining = num_gens;
+      while (remaining > 0) {
+        // Run to the next migration (or to the end), each island as a single task.
+        const int to_migration = migrate_interval - generation % migrate_interval;
+        const int run_gens = std::min(remaining, to_migration);
+        pool.ParallelFor(islands.size(), [this, run_gens, &step_fun](size_t id){
+            Island & island = *islands[id];
+            for (int gen = 0; gen < run_gens; gen++) step_fun(island.pop, island.random);
+          }, 1);
+        generation += run_gens;
+        remaining -= run_gens;
+        if (generation % migrate_interval == 0) Migrate();
+      }
+    }
+
+    // The best organism over all islands (ties favor the lower island, then earlier id).
+    ORG & GetBest() {
+      int best_island = 0;
+      int best_id = 0;
+      double best_fit = 0.0;
+      for (int i = 0; i < GetNumIslands(); i++) {
+        Population<ORG> & pop = islands[i]->pop;
+        for (int id = 0; id < pop.GetSize(); id++) {
+          const double fit = fit_fun(&pop[id]);
+          if ((i == 0 && id == 0) || fit > best_fit) {
+            best_island = i;
+            best_id = id;
+            best_fit = fit;
+          }
+        }
+      }
+      return islands[best_island]->pop[best_id];
+    }
+  };
+
+}
+
+#endif
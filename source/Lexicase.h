@@ -0,0 +1,230 @@
+//  This file is part of PuzzleEngine, https://github.com/mercere99/PuzzleEngine/
+//  Copyright (C) Michigan State University, 2015.
+//  Released under the MIT Software license; see doc/LICENSE
+//
+//
+//  Lexicase and epsilon-lexicase selection over a precomputed objective matrix.
+//
+//  An ObjectiveMatrix holds one score per organism per objective (higher is better); it is
+//  filled once per generation, so selection never calls a fitness function.  Each
+//  selection shuffles the objectives and, one objective at a time, keeps only the
+//  candidates that are best on it (or within epsilon of the best), until one candidate is
+//  left or the objectives run out; a random survivor wins.
+//
+//  LexicaseSelector prepares the matrix once per generation so that each selection is
+//  mostly whole-word bit operations:
+//  * Candidate sets are bitsets.
+//  * For every objective, the set of organisms within epsilon of the population's best
+//    (the "elite" set) is cached.  Every selection starts with all organisms, so its first
+//    filter is exactly the elite set of its first objective and costs a copy.
+//  * Later filters are also a word-wise AND with the elite set whenever a candidate holds
+//    the population's best score; only otherwise are the candidates' scores scanned.
+//  * Objectives on which every organism is within epsilon of the best never remove
+//    anyone and are dropped.
+//
+//  Epsilon can be zero (standard lexicase), a fixed value, or set per objective to the
+//  median absolute deviation of its scores (as in automatic epsilon-lexicase).
+
+#ifndef PZE_LEXICASE_H
+#define PZE_LEXICASE_H
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include "base/assert.hpp"
+#include "math/Random.hpp"
+#include "Puzzle.h"
+
+namespace pze {
+
+  class ObjectiveMatrix {
+  private:
+    int num_orgs;
+    int num_objs;
+    std::vector<double> scores;     // Objective-major: all organisms' scores for objective 0 first.
+
+  public:
+    ObjectiveMatrix(int in_orgs=0, int in_objs=0)
+      : num_orgs(in_orgs), num_objs(in_objs), scores((size_t) in_orgs * in_objs, 0.0) { ; }
+
+    int GetNumOrgs() const { return num_orgs; }
+    int GetNumObjectives() const { return num_objs; }
+
+    double Get(int org, int obj) const { return scores[(size_t) obj * num_orgs + org]; }
+    void Set(int org, int obj, double score) { scores[(size_t) obj * num_orgs + org] = score; }
+    const double * GetObjective(int obj) const { return scores.data() + (size_t) obj * num_orgs; }
+
+    void Resize(int in_orgs, int in_objs) {
+      num_orgs = in_orgs;
+      num_objs = in_objs;
+      scores.assign((size_t) in_orgs * in_objs, 0.0);
+    }
+  };
+
+  // Objectives taken from a solving profile: a unique solution, the number of steps, and
+  // the number of moves made at each level (so harder techniques each count separately).
+  static constexpr int NUM_PROFILE_OBJECTIVES = 2 + PuzzleProfile::MAX_LEVEL + 1;
+
+  inline void SetProfileObjectives(ObjectiveMatrix & matrix, int org, const PuzzleProfile & profile) {
+    emp_assert(matrix.GetNumObjectives() == NUM_PROFILE_OBJECTIVES);
+    std::array<int, PuzzleProfile::MAX_LEVEL + 1> moves{};
+    for (int i = 0; i < profile.GetSize(); i++) moves[profile.GetLevel(i)] += profile.GetCount(i);
+    matrix.Set(org, 0, profile.IsUnique() ? 1.0 : 0.0);
+    matrix.Set(org, 1, profile.GetSize());
+    for (int level = 0; level <= PuzzleProfile::MAX_LEVEL; level++) matrix.Set(org, 2 + level, moves[level]);
+  }
+
+  // Build the profile objectives for every organism of an evaluated population.
+  template <typename POP_T>
+  ObjectiveMatrix BuildProfileObjectives(const POP_T & pop) {
+    ObjectiveMatrix matrix(pop.GetSize(), NUM_PROFILE_OBJECTIVES);
+    for (int i = 0; i < pop.GetSize(); i++) SetProfileObjectives(matrix, i, pop[i].GetProfile());
+    return matrix;
+  }
+
+  class LexicaseSelector {
+  public:
+    enum class Epsilon { NONE, FIXED, MAD };
+
+  private:
+    using bits_t = std::vector<uint64_t>;
+
+    const ObjectiveMatrix * matrix;
+    int num_orgs;
+    int num_words;
+    std::vector<int> active;          // Objectives that can tell organisms apart.
+    std::vector<double> epsilon;      // Per objective.
+    std::vector<bits_t> elite;        // Per objective: organisms within epsilon of the best.
+    std::vector<bits_t> top;          // Per objective: organisms with the best score.
+    std::vector<int> elite_count;
+
+    // Scratch space reused by every selection.
+    std::vector<int> order;
+    bits_t candidates;
+
+    static int CountBits(const bits_t & bits) {
+      int count = 0;
+      for (uint64_t word : bits) count += __builtin_popcountll(word);
+      return count;
+    }
+
+    static bool Intersects(const bits_t & a, const bits_t & b) {
+      for (size_t w = 0; w < a.size(); w++) if (a[w] & b[w]) return true;
+      return false;
+    }
+
+    static double CalcMAD(const double * scores, int count) {
+      std::vector<double> values(scores, scores + count);
+      const auto mid = values.begin() + count / 2;
+      std::nth_element(values.begin(), mid, values.end());
+      const double median = *mid;
+      for (double & value : values) value = std::abs(value - median);
+      std::nth_element(values.begin(), mid, values.end());
+      return *mid;
+    }
+
+    // Keep only the candidates within epsilon of the best candidate on an objective;
+    // return how many are left.
+    int Filter(int obj) {
+      if (Intersects(candidates, top[obj])) {       // A candidate has the population's best.
+        int count = 0;
+        for (int w = 0; w < num_words; w++) {
+          candidates[w] &= elite[obj][w];
+          count += __builtin_popcountll(candidates[w]);
+        }
+        return count;
+      }
+
+      const double * scores = matrix->GetObjective(obj);
+      double best = -INFINITY;
+      for (int w = 0; w < num_words; w++) {
+        for (uint64_t bits = candidates[w]; bits; bits &= bits - 1) {
+          best = std::max(best, scores[w * 64 + __builtin_ctzll(bits)]);
+        }
+      }
+      const double threshold = best - epsilon[obj];
+      int count = 0;
+      for (int w = 0; w < num_words; w++) {
+        for (uint64_t bits = candidates[w]; bits; bits &= bits - 1) {
+          const int bit = __builtin_ctzll(bits);
+          if (scores[w * 64 + bit] < threshold) candidates[w] &= ~(1ull << bit);
+        }
+        count += __builtin_popcountll(candidates[w]);
+      }
+      return count;
+    }
+
+    // Pick one of count candidates at random.
+    int PickCandidate(int count, emp::Random & random) const {
+      int skip = (count > 1) ? (int) random.GetUInt(count) : 0;
+      for (int w = 0; w < num_words; w++) {
+        const int word_count = __builtin_popcountll(candidates[w]);
+        if (skip >= word_count) { skip -= word_count; continue; }
+        uint64_t bits = candidates[w];
+        for (; skip > 0; skip--) bits &= bits - 1;
+        return w * 64 + __builtin_ctzll(bits);
+      }
+      emp_assert(false, "candidate not found");
+      return 0;
+    }
+
+  public:
+    LexicaseSelector() : matrix(nullptr), num_orgs(0), num_words(0) { ; }
+
+    int GetNumActiveObjectives() const { return (int) active.size(); }
+
+    // Prepare to select from a matrix (which must outlive the selections).  With
+    // Epsilon::FIXED, fixed_epsilon is used for every objective.
+    void Setup(const ObjectiveMatrix & in_matrix, Epsilon mode=Epsilon::NONE, double fixed_epsilon=0.0) {
+      matrix = &in_matrix;
+      num_orgs = in_matrix.GetNumOrgs();
+      num_words = (num_orgs + 63) / 64;
+      const int num_objs = in_matrix.GetNumObjectives();
+      active.clear();
+      epsilon.assign(num_objs, 0.0);
+      elite.assign(num_objs, bits_t(num_words, 0));
+      top.assign(num_objs, bits_t(num_words, 0));
+      elite_count.assign(num_objs, 0);
+      candidates.assign(num_words, 0);
+      if (num_orgs == 0) return;
+
+      for (int obj = 0; obj < num_objs; obj++) {
+        const double * scores = in_matrix.GetObjective(obj);
+        if (mode == Epsilon::FIXED) epsilon[obj] = fixed_epsilon;
+        else if (mode == Epsilon::MAD) epsilon[obj] = CalcMAD(scores, num_orgs);
+
+        const double best = *std::max_element(scores, scores + num_orgs);
+        const double threshold = best - epsilon[obj];
+        for (int i = 0; i < num_orgs; i++) {
+          if (scores[i] >= threshold) elite[obj][i / 64] |= 1ull << (i % 64);
+          if (scores[i] == best) top[obj][i / 64] |= 1ull << (i % 64);
+        }
+        elite_count[obj] = CountBits(elite[obj]);
+        if (elite_count[obj] < num_orgs) active.push_back(obj);
+      }
+    }
+
+    // Run one selection; return the id of the winner.
+    int Select(emp::Random & random) {
+      emp_assert(matrix != nullptr && num_orgs > 0);
+      if (active.empty()) return (int) random.GetUInt(num_orgs);
+
+      // Shuffle the objectives (Fisher-Yates).
+      order = active;
+      for (int i = (int) order.size() - 1; i > 0; i--) {
+        std::swap(order[i], order[random.GetUInt(i + 1)]);
+      }
+
+      // The first filter is always the cached elite set.
+      candidates = elite[order[0]];
+      int count = elite_count[order[0]];
+      for (size_t i = 1; i < order.size() && count > 1; i++) count = Filter(order[i]);
+      return PickCandidate(count, random);
+    }
+  };
+
+}
+
+#endif
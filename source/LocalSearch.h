@@ -0,0 +1,185 @@
+//  This file is part of PuzzleEngine, https://github.com/mercere99/PuzzleEngine/
+//  Copyright (C) Michigan State University, 2015.
+//  Released under the MIT Software license; see doc/LICENSE
+//
+//
+//  Local search over a puzzle's start cells, for polishing puzzles that are nearly done.
+//
+//  Each step evaluates all 81 single-toggle neighbors of the current puzzle (the puzzle
+//  with one cell's start flag flipped) and moves to the best one.  Without tabu, only
+//  moves that improve on the current fitness are taken, so the search stops at the first
+//  local optimum.  With a tabu tenure, the best move is taken even if it is worse, except
+//  that a cell toggled in the last tenure steps may not be toggled again unless doing so
+//  beats the best puzzle found so far.  Either way, when the search stalls it can restart
+//  from the best puzzle, perturbed with MutateStart(), up to a given number of times.
+//
+//  All neighbors share the current puzzle's solution grid, so they are kept from step to
+//  step: after the move that toggles cell m, every neighbor is updated by toggling cell m
+//  too.  A step thus costs 81 flag flips plus 81 profiles, which are calculated in
+//  SudokuBatch groups spread over a ThreadPool (and taken from the profile cache, if one
+//  is in use).  Ties between equally good moves are broken by the caller's emp::Random,
+//  only on the calling thread, so a given seed gives the same search for any number of
+//  threads.
+
+#ifndef PZE_LOCAL_SEARCH_H
+#define PZE_LOCAL_SEARCH_H
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <functional>
+#include <vector>
+#include "base/assert.hpp"
+#include "math/Random.hpp"
+#include "Sudoku.h"
+#include "SudokuBatch.h"
+#include "ThreadPool.h"
+
+namespace pze {
+
+  class SudokuLocalSearch {
+  public:
+    using fit_fun_t = std::function<double(Sudoku*)>;
+
+    struct Config {
+      int max_steps = 1000;         // Neighborhoods to evaluate, over all restarts.
+      int tabu_tenure = 0;          // Steps a toggled cell stays tabu; 0 for plain hill climbing.
+      int patience = 50;            // With tabu, steps without a new best before a restart.
+      int max_restarts = 0;
+      double restart_p = 0.05;      // Chance of each cell being toggled on a restart.
+    };
+
+    // Totals from the most recent Run().
+    struct RunStats {
+      int steps = 0;                // Moves taken.
+      int improvements = 0;         // Steps that found a new best puzzle.
+      int restarts = 0;
+      size_t evaluations = 0;       // Neighbors evaluated (including profile cache hits).
+      double seconds = 0.0;
+      double GetEvalsPerSec() const { return seconds > 0.0 ? evaluations / seconds : 0.0; }
+    };
+
+  private:
+    static constexpr int NUM_CELLS = 81;
+
+    ThreadPool & pool;
+    fit_fun_t fit_fun;
+    std::vector<Sudoku> neighbors;              // neighbors[i] is current with cell i toggled.
+    std::array<double, NUM_CELLS> neighbor_fit;
+    std::array<int, NUM_CELLS> last_toggled;    // Step at which each cell was last toggled.
+    RunStats stats;
+
+    // Make every neighbor a copy of current with its own cell toggled.
+    void BuildNeighbors(const Sudoku & current) {
+      neighbors.assign(NUM_CELLS, current);
+      for (int i = 0; i < NUM_CELLS; i++) neighbors[i].SetStart(i, !current.GetStart(i));
+    }
+
+    // The move toggling cell m was taken; the neighbors of the new puzzle differ from the
+    // old ones by that same toggle.
+    void ShiftNeighbors(int m) {
+      for (Sudoku & puz : neighbors) puz.SetStart(m, !puz.GetStart(m));
+    }
+
+    void EvaluateNeighbors() {
+      const size_t group_size = SudokuBatch::NUM_LANES;
+      const size_t num_groups = (NUM_CELLS + group_size - 1) / group_size;
+      pool.ParallelFor(num_groups, [this, group_size](size_t group){
+          const size_t start = group * group_size;
+          const size_t end = std::min(start + group_size, (size_t) NUM_CELLS);
+          std::array<Sudoku *, SudokuBatch::NUM_LANES> todo;
+          for (size_t i = start; i < end; i++) todo[i - start] = &neighbors[i];
+          SudokuBatch batch;
+          batch.Evaluate(todo.data(), end - start);
+          for (size_t i = start; i < end; i++) neighbor_fit[i] = fit_fun(&neighbors[i]);
+        }, 1);
+      stats.evaluations += NUM_CELLS;
+    }
+
+    // Pick the best allowed move, or -1 if there is none; ties are broken at random.
+    int PickMove(const Config & config, int step, double best_fit, emp::Random & random) const {
+      int move = -1;
+      int num_ties = 0;
+      for (int i = 0; i < NUM_CELLS; i++) {
+        const bool tabu = config.tabu_tenure > 0 && step - last_toggled[i] <= config.tabu_tenure;
+        if (tabu && neighbor_fit[i] <= best_fit) continue;
+        if (move == -1 || neighbor_fit[i] > neighbor_fit[move]) {
+          move = i;
+          num_ties = 1;
+        } else if (neighbor_fit[i] == neighbor_fit[move] && random.GetUInt(++num_ties) == 0) {
+          move = i;
+        }
+      }
+      return move;
+    }
+
+  public:
+    SudokuLocalSearch(ThreadPool & in_pool,
+                      fit_fun_t in_fit_fun=[](Sudoku * puz){ return puz->CalcSimpleFitness(); })
+      : pool(in_pool), fit_fun(in_fit_fun) { ; }
+    SudokuLocalSearch(const SudokuLocalSearch &) = delete;
+    ~SudokuLocalSearch() { ; }
+    SudokuLocalSearch & operator=(const SudokuLocalSearch &) = delete;
+
+    const RunStats & GetStats() const { return stats; }
+
+    // Search from start, which must have a full solution grid; return the best puzzle
+    // found (evaluated).
+    Sudoku Run(const Sudoku & start, emp::Random & random, const Config & config) {
+      emp_assert(start.HasFullGrid(), "Local search toggles start cells, so it needs the full grid.");
+      const auto start_time = std::chrono::steady_clock::now();
+      stats = RunStats();
+
+      Sudoku current(start);
+      double current_fit = fit_fun(&current);
+      Sudoku best(current);
+      double best_fit = current_fit;
+      int stall = 0;                              // Steps since the last new best.
+
+      BuildNeighbors(current);
+      last_toggled.fill(-config.tabu_tenure - 1);
+
+      for (int step = 0; step < config.max_steps; step++) {
+        EvaluateNeighbors();
+        const int move = PickMove(config, step, best_fit, random);
+        const bool stuck = (move == -1) || (config.tabu_tenure == 0 && neighbor_fit[move] <= current_fit);
+
+        if (!stuck) {
+          current = neighbors[move];
+          current_fit = neighbor_fit[move];
+          ShiftNeighbors(move);
+          last_toggled[move] = step;
+          stats.steps++;
+          if (current_fit > best_fit) {
+            best = current;
+            best_fit = current_fit;
+            stats.improvements++;
+            stall = 0;
+          } else stall++;
+        }
+
+        // Restart from a perturbed copy of the best puzzle once progress stops.
+        if (stuck || (config.tabu_tenure > 0 && stall >= config.patience)) {
+          if (stats.restarts == config.max_restarts) break;
+          stats.restarts++;
+          current = best;
+          current.MutateStart(random, config.restart_p);
+          current_fit = fit_fun(&current);
+          if (current_fit > best_fit) {
+            best = current;
+            best_fit = current_fit;
+          }
+          BuildNeighbors(current);
+          last_toggled.fill(-config.tabu_tenure - 1);
+          stall = 0;
+        }
+      }
+
+      stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+      return best;
+    }
+  };
+
+}
+
+#endif
@@ -0,0 +1,107 @@
+//  This file is part of PuzzleEngine, https://github.com/mercere99/PuzzleEngine/
+//  Copyright (C) Michigan State University, 2015.
+//  Released under the MIT Software license; see doc/LICENSE
+//
+//
+//  Compact moves and a fixed-capacity buffer to collect them in.
+//
+//  A PackedMove holds a whole PuzzleMove in one 16-bit word: the move type in the top
+//  bit, the position in the next eleven bits, and the state in the low four bits.
+//  A MoveBuffer is a plain array of them with a size, meant to live on the stack and be
+//  reused, so solving techniques can report moves without touching the heap.
+
+#ifndef PZE_MOVE_BUFFER_H
+#define PZE_MOVE_BUFFER_H
+
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "base/assert.hpp"
+#include "Puzzle.h"
+
+namespace pze {
+
+  class PackedMove {
+  private:
+    static constexpr uint16_t TYPE_BIT = 0x8000;
+    static constexpr int POS_SHIFT = 4;
+    static constexpr uint16_t STATE_MASK = 0x000F;
+
+    uint16_t bits;
+
+  public:
+    static constexpr int MAX_POS = 2047;
+    static constexpr int MAX_STATE = 15;
+
+    PackedMove() = default;   // Left uninitialized, so buffers of moves are free to create.
+    PackedMove(PuzzleMove::MoveType type, int pos, int state)
+      : bits((uint16_t) (((type == PuzzleMove::BLOCK_STATE) ? TYPE_BIT : 0) | (pos << POS_SHIFT) | state))
+    {
+      emp_assert(pos >= 0 && pos <= MAX_POS, pos);
+      emp_assert(state >= 0 && state <= MAX_STATE, state);
+    }
+    PackedMove(const PuzzleMove & move) : PackedMove(move.GetType(), move.GetID(), move.GetState()) { ; }
+    PackedMove(const PackedMove &) = default;
+    PackedMove & operator=(const PackedMove &) = default;
+
+    bool IsSet() const { return (bits & TYPE_BIT) == 0; }
+    bool IsBlock() const { return bits & TYPE_BIT; }
+    PuzzleMove::MoveType GetType() const { return IsSet() ? PuzzleMove::SET_STATE : PuzzleMove::BLOCK_STATE; }
+    int GetID() const { return (bits & ~TYPE_BIT) >> POS_SHIFT; }
+    int GetState() const { return bits & STATE_MASK; }
+    uint16_t GetBits() const { return bits; }
+
+    PuzzleMove ToMove() const { return PuzzleMove(GetType(), GetID(), GetState()); }
+
+    bool operator==(const PackedMove & in) const { return bits == in.bits; }
+    bool operator!=(const PackedMove & in) const { return bits != in.bits; }
+  };
+
+  class MoveBuffer {
+  public:
+    // Enough for any single technique on a 9x9 board: at most 81*9 = 729 distinct blocks,
+    // or 27*9 = 243 hidden singles (each found once per region).
+    static constexpr int CAPACITY = 1024;
+
+  private:
+    std::array<PackedMove, CAPACITY> moves;
+    int num_moves;
+
+  public:
+    MoveBuffer() : num_moves(0) { ; }
+    MoveBuffer(const MoveBuffer &) = default;
+    ~MoveBuffer() { ; }
+    MoveBuffer & operator=(const MoveBuffer &) = default;
+
+    int GetSize() const { return num_moves; }
+    bool IsEmpty() const { return num_moves == 0; }
+    const PackedMove & operator[](int id) const { return moves[id]; }
+
+    const PackedMove * begin() const { return moves.data(); }
+    const PackedMove * end() const { return moves.data() + num_moves; }
+
+    void Clear() { num_moves = 0; }
+
+    // Every technique dedups its moves, so the buffer should never fill; if it somehow
+    // does (even with asserts compiled out), later moves are dropped rather than written
+    // past the end.  Any subset of valid moves is still valid, just less progress.
+    void Add(PuzzleMove::MoveType type, int pos, int state) {
+      emp_assert(num_moves < CAPACITY, num_moves);
+      if (num_moves == CAPACITY) return;
+      moves[num_moves++] = PackedMove(type, pos, state);
+    }
+    void AddSet(int pos, int state) { Add(PuzzleMove::SET_STATE, pos, state); }
+    void AddBlock(int pos, int state) { Add(PuzzleMove::BLOCK_STATE, pos, state); }
+
+    // Unpack into full PuzzleMoves (for the std::vector based API).
+    std::vector<PuzzleMove> ToVector() const {
+      std::vector<PuzzleMove> out;
+      out.reserve(num_moves);
+      for (int i = 0; i < num_moves; i++) out.push_back(moves[i].ToMove());
+      return out;
+    }
+  };
+
+}
+
+#endif
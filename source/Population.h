@@ -0,0 +1,112 @@
+//  This file is part of PuzzleEngine, https://github.com/mercere99/PuzzleEngine/
+//  Copyright (C) Michigan State University, 2015.
+//  Released under the MIT Software license; see doc/LICENSE
+//
+//
+//  A simple generational population of puzzles, following the interface of the
+//  original emp::EA::Population (Insert, EliteSelect, TournamentSelect, Update).
+//
+//  Selection only reads fitness values, so a generation is run as three stages:
+//  mutate (serial, so random draws stay in a fixed order), evaluate (in parallel;
+//  see EvaluatePopulation), and select (serial).  Given the same seed, every stage
+//  produces the same result regardless of the number of threads.
+
+#ifndef PZE_POPULATION_H
+#define PZE_POPULATION_H
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <vector>
+#include "base/assert.hpp"
+#include "math/Random.hpp"
+#include "ThreadPool.h"
+
+namespace pze {
+
+  template <typename ORG>
+  class Population {
+  private:
+    std::vector<ORG> pop;        // The current generation.
+    std::vector<ORG> next_pop;   // Organisms selected for the next generation.
+
+  public:
+    using fit_fun_t = std::function<double(ORG*)>;
+
+    Population() { ; }
+    Population(const Population &) = default;
+    ~Population() { ; }
+    Population & operator=(const Population &) = default;
+
+    int GetSize() const { return (int) pop.size(); }
+    ORG & operator[](int id) { return pop[id]; }
+    const ORG & operator[](int id) const { return pop[id]; }
+
+    void Clear() { pop.clear(); next_pop.clear(); }
+
+    // Add copies of an organism to the current generation.
+    void Insert(const ORG & org, int copy_count=1) {
+      for (int i = 0; i < copy_count; i++) pop.push_back(org);
+    }
+
+    // Copy the e_count top organisms into the next generation, copy_count times each.
+    // Ties are broken in favor of the earlier organism.
+    void EliteSelect(fit_fun_t fit_fun, int e_count=1, int copy_count=1) {
+      emp_assert(e_count > 0 && e_count <= (int) pop.size(), e_count);
+      std::vector<double> fitness(pop.size());
+      std::vector<int> order(pop.size());
+      for (size_t i = 0; i < pop.size(); i++) fitness[i] = fit_fun(&pop[i]);
+      std::iota(order.begin(), order.end(), 0);
+      std::stable_sort(order.begin(), order.end(),
+                       [&fitness](int a, int b){ return fitness[a] > fitness[b]; });
+      for (int i = 0; i < e_count; i++) {
+        for (int j = 0; j < copy_count; j++) next_pop.push_back(pop[order[i]]);
+      }
+    }
+
+    // Run tourny_count tournaments, each among t_size random organisms; the winners
+    // move on to the next generation.
+    void TournamentSelect(fit_fun_t fit_fun, int t_size, emp::Random & random, int tourny_count=1) {
+      emp_assert(t_size > 0 && pop.size() > 0, t_size);
+      std::vector<double> fitness(pop.size());
+      for (size_t i = 0; i < pop.size(); i++) fitness[i] = fit_fun(&pop[i]);
+
+      for (int T = 0; T < tourny_count; T++) {
+        int best_id = (int) random.GetUInt(pop.size());
+        for (int i = 1; i < t_size; i++) {
+          const int id = (int) random.GetUInt(pop.size());
+          if (fitness[id] > fitness[best_id]) best_id = id;
+        }
+        next_pop.push_back(pop[best_id]);
+      }
+    }
+
+    // Run count selections with a selector whose Select(random) returns an organism id
+    // (such as a LexicaseSelector); the winners move on to the next generation.
+    template <typename SELECTOR>
+    void SelectWith(SELECTOR & selector, emp::Random & random, int count=1) {
+      for (int i = 0; i < count; i++) {
+        const int id = selector.Select(random);
+        emp_assert(id >= 0 && id < (int) pop.size(), id);
+        next_pop.push_back(pop[id]);
+      }
+    }
+
+    // Move the selected organisms into place as the current generation.
+    void Update() {
+      std::swap(pop, next_pop);
+      next_pop.clear();
+    }
+  };
+
+  // Evaluate every organism in a population, in parallel.  Each organism caches its
+  // own profile and fitness, so the selection that follows only reads stored values.
+  // Works with any population type offering GetSize() and operator[].
+  template <typename POP_T>
+  void EvaluatePopulation(POP_T & pop, ThreadPool & pool) {
+    pool.ParallelFor((size_t) pop.GetSize(), [&pop](size_t i){ pop[(int) i].CalcProfile(); }, 16);
+  }
+
+}
+
+#endif
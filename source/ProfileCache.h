@@ -0,0 +1,172 @@
+//  This file is part of PuzzleEngine, https://github.com/mercere99/PuzzleEngine/
+//  Copyright (C) Michigan State University, 2015.
+//  Released under the MIT Software license; see doc/LICENSE
+//
+//
+//  A fixed-size transposition cache of solving profiles.
+//
+//  Each entry maps a (start mask, solution grid id) pair to the PuzzleProfile and
+//  fitness computed for it.  The table is direct-mapped: a new entry simply replaces
+//  whatever was in its slot.  Every slot is guarded by a sequence counter, so lookups
+//  never take a lock; a lookup that races with a write to the same slot is counted as
+//  a miss.  Writers that find a slot busy skip the insert.
+//
+//  Profile steps are stored in the same packed 16-bit form PuzzleProfile uses; profiles
+//  with more than MAX_ENTRIES steps are not cached.
+
+#ifndef PZE_PROFILE_CACHE_H
+#define PZE_PROFILE_CACHE_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include "CellMask.h"
+#include "Puzzle.h"
+
+namespace pze {
+
+  class ProfileCache {
+  public:
+    static constexpr int MAX_ENTRIES = 60;          // Most profile steps stored per slot.
+
+  private:
+    static constexpr int ENTRY_WORDS = MAX_ENTRIES / 4;  // Four packed steps per word.
+
+    // Word layout of a slot (after the sequence counter).
+    enum SlotWord { MASK_LO=0, MASK_HI, GRID_ID, META, FITNESS, ENTRIES, NUM_WORDS = ENTRIES + ENTRY_WORDS };
+
+    struct Slot {
+      std::atomic<uint64_t> seq;                    // Odd while being written.
+      std::array<std::atomic<uint64_t>, NUM_WORDS> words;
+    };
+
+    // Counters are kept on their own cache lines to limit contention between threads.
+    struct alignas(64) Counter {
+      std::atomic<uint64_t> value;
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    size_t num_slots;
+    size_t slot_mask;
+    Counter hits;
+    Counter misses;
+    Counter inserts;
+
+    static uint64_t Mix(uint64_t x) {
+      x ^= x >> 33;
+      x *= 0xff51afd7ed558ccdull;
+      x ^= x >> 33;
+      x *= 0xc4ceb9fe1a85ec53ull;
+      x ^= x >> 33;
+      return x;
+    }
+
+    size_t CalcSlotID(const CellMask & mask, uint64_t grid_id) const {
+      return Mix(mask.GetLo() ^ Mix(mask.GetHi() ^ Mix(grid_id))) & slot_mask;
+    }
+
+  public:
+    // The number of slots is rounded up to a power of two.
+    ProfileCache(size_t min_slots=(1 << 16)) : num_slots(1) {
+      while (num_slots < min_slots) num_slots <<= 1;
+      slot_mask = num_slots - 1;
+      slots = std::make_unique<Slot[]>(num_slots);
+      Clear();
+    }
+    ProfileCache(const ProfileCache &) = delete;
+    ~ProfileCache() { ; }
+    ProfileCache & operator=(const ProfileCache &) = delete;
+
+    size_t GetSize() const { return num_slots; }
+    uint64_t GetHits() const { return hits.value.load(std::memory_order_relaxed); }
+    uint64_t GetMisses() const { return misses.value.load(std::memory_order_relaxed); }
+    uint64_t GetInserts() const { return inserts.value.load(std::memory_order_relaxed); }
+    double GetHitRate() const {
+      const uint64_t total = GetHits() + GetMisses();
+      return total ? ((double) GetHits()) / (double) total : 0.0;
+    }
+
+    void ResetStats() {
+      hits.value.store(0, std::memory_order_relaxed);
+      misses.value.store(0, std::memory_order_relaxed);
+      inserts.value.store(0, std::memory_order_relaxed);
+    }
+
+    // Remove all entries.  Must not run concurrently with other operations.
+    void Clear() {
+      for (size_t i = 0; i < num_slots; i++) {
+        slots[i].seq.store(0, std::memory_order_relaxed);
+        for (auto & word : slots[i].words) word.store(0, std::memory_order_relaxed);
+        slots[i].words[META].store(~0ull, std::memory_order_relaxed);  // Mark slot as empty.
+      }
+      ResetStats();
+    }
+
+    // Look up a profile; return true and fill in profile and fitness on a hit.
+    bool Lookup(const CellMask & mask, uint64_t grid_id, PuzzleProfile & profile, double & fitness) {
+      Slot & slot = slots[CalcSlotID(mask, grid_id)];
+
+      std::array<uint64_t, NUM_WORDS> words;
+      const uint64_t seq_start = slot.seq.load(std::memory_order_acquire);
+      for (int i = 0; i < NUM_WORDS; i++) words[i] = slot.words[i].load(std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      const uint64_t seq_end = slot.seq.load(std::memory_order_relaxed);
+
+      if ((seq_start & 1) || seq_start != seq_end || words[META] == ~0ull
+          || words[MASK_LO] != mask.GetLo() || words[MASK_HI] != mask.GetHi()
+          || words[GRID_ID] != grid_id) {
+        misses.value.fetch_add(1, std::memory_order_relaxed);
+        return false;
+      }
+
+      // META holds the number of steps (8 bits), solution count + 1 (16 bits), and solved (1 bit).
+      const int size = (int) (words[META] & 0xFF);
+      profile.Clear();
+      for (int i = 0; i < size; i++) {
+        profile.AddStep((uint16_t) (words[ENTRIES + i/4] >> (16 * (i%4))));
+      }
+      profile.SetSolutionCount((int) ((words[META] >> 8) & 0xFFFF) - 1);
+      profile.SetSolved((words[META] >> 24) & 1);
+      std::memcpy(&fitness, &words[FITNESS], sizeof(double));
+
+      hits.value.fetch_add(1, std::memory_order_relaxed);
+      return true;
+    }
+
+    // Store a profile; return false if it could not be cached.
+    bool Insert(const CellMask & mask, uint64_t grid_id, const PuzzleProfile & profile, double fitness) {
+      const int size = profile.GetSize();
+      if (size > MAX_ENTRIES || profile.GetSolutionCount() >= 0xFFFF) return false;
+
+      std::array<uint64_t, NUM_WORDS> words;
+      words.fill(0);
+      words[MASK_LO] = mask.GetLo();
+      words[MASK_HI] = mask.GetHi();
+      words[GRID_ID] = grid_id;
+      words[META] = (uint64_t) size | ((uint64_t) (profile.GetSolutionCount() + 1) << 8)
+        | ((uint64_t) profile.IsSolved() << 24);
+      std::memcpy(&words[FITNESS], &fitness, sizeof(double));
+      for (int i = 0; i < size; i++) {
+        words[ENTRIES + i/4] |= ((uint64_t) profile.GetStep(i)) << (16 * (i%4));
+      }
+
+      // Claim the slot by making its sequence number odd; skip if another writer has it.
+      Slot & slot = slots[CalcSlotID(mask, grid_id)];
+      uint64_t seq = slot.seq.load(std::memory_order_relaxed);
+      if ((seq & 1) || !slot.seq.compare_exchange_strong(seq, seq + 1, std::memory_order_acquire)) {
+        return false;
+      }
+      std::atomic_thread_fence(std::memory_order_release);
+      for (int i = 0; i < NUM_WORDS; i++) slot.words[i].store(words[i], std::memory_order_relaxed);
+      slot.seq.store(seq + 2, std::memory_order_release);
+
+      inserts.value.fetch_add(1, std::memory_order_relaxed);
+      return true;
+    }
+  };
+
+}
+
+#endif
@@ -10,6 +10,13 @@
 #ifndef PZE_PUZZLE_H
 #define PZE_PUZZLE_H
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
 namespace pze {
 
   class PuzzleMove {
@@ -37,36 +44,127 @@ namespace pze {
   };
 
 
+  // The steps taken while solving a puzzle.  Each step records the level of the technique
+  // used and how many moves it made, packed into one 16-bit word (level in the top four
+  // bits, count in the low twelve).  The first INLINE_CAPACITY steps are stored in the
+  // profile itself; longer profiles spill all of their steps into a vector, whose space is
+  // kept for reuse across Clear().
   class PuzzleProfile {
+  public:
+    static constexpr int INLINE_CAPACITY = 30;
+    static constexpr int MAX_LEVEL = 15;
+    static constexpr int MAX_COUNT = 4095;
+    static constexpr int LEVEL_WEIGHT = 16;   // Distance() cost of one level of difference.
+
   protected:
-    std::vector<int> levels;  // How hard were each set of moves?
-    std::vector<int> counts;  // How many options were there for each set of moves?
+    std::array<uint16_t, INLINE_CAPACITY> inline_steps;  // Steps, while they fit.
+    std::vector<uint16_t> spill_steps;                   // All steps, once they don't.
+    int num_steps;            // How many sets of moves were made?
+    int solution_count;       // How many solutions (up to a limit) does it have? -1 = unknown
     bool solved;              // Was the puzzle solved?
 
+    const uint16_t * GetSteps() const {
+      return (num_steps <= INLINE_CAPACITY) ? inline_steps.data() : spill_steps.data();
+    }
+
+    static int StepDistance(int a, int b) {
+      const int level_diff = (a >> 12) - (b >> 12);
+      const int count_diff = (a & MAX_COUNT) - (b & MAX_COUNT);
+      return LEVEL_WEIGHT * (level_diff < 0 ? -level_diff : level_diff)
+        + (count_diff < 0 ? -count_diff : count_diff);
+    }
+
+    static uint64_t Mix(uint64_t x) {
+      x ^= x >> 30;
+      x *= 0xbf58476d1ce4e5b9ull;
+      x ^= x >> 27;
+      x *= 0x94d049bb133111ebull;
+      x ^= x >> 31;
+      return x;
+    }
+
   public:
-    PuzzleProfile() { ; }
+    PuzzleProfile() : num_steps(0), solution_count(-1), solved(false) { ; }
+    PuzzleProfile(const PuzzleProfile &) = default;
     ~PuzzleProfile() { ; }
     PuzzleProfile & operator=(const PuzzleProfile &) = default;
 
-    int GetSize() const { return (int) counts.size(); }
-    int GetLevel(int id) const { return levels[id]; }
-    int GetCount(int id) const { return counts[id]; }
+    int GetSize() const { return num_steps; }
+    int GetLevel(int id) const { return GetStep(id) >> 12; }
+    int GetCount(int id) const { return GetStep(id) & MAX_COUNT; }
+    uint16_t GetStep(int id) const { return GetSteps()[id]; }   // Packed level and count.
     bool IsSolved() const { return solved; }
-    
+    int GetSolutionCount() const { return solution_count; }
+    bool IsUnique() const { return solution_count == 1; }
+
+    // Add a packed step.
+    void AddStep(uint16_t step) {
+      if (num_steps < INLINE_CAPACITY) {
+        inline_steps[num_steps++] = step;
+        return;
+      }
+      if (num_steps == INLINE_CAPACITY) {
+        spill_steps.assign(inline_steps.begin(), inline_steps.end());
+      }
+      spill_steps.push_back(step);
+      num_steps++;
+    }
+
+    // Add a step; levels and counts outside the packed range are clamped to it.
     void AddMoves(int level, int count) {
-      levels.push_back(level);
-      counts.push_back(count);
+      level = std::clamp(level, 0, MAX_LEVEL);
+      count = std::clamp(count, 0, MAX_COUNT);
+      AddStep((uint16_t) ((level << 12) | count));
     }
     void SetSolved(bool in_solved) { solved = in_solved; }
+    void SetSolutionCount(int in_count) { solution_count = in_count; }
 
     void Clear() {
-      levels.resize(0);
-      counts.resize(0);
+      num_steps = 0;
+      spill_steps.clear();
+      solution_count = -1;
+      solved = false;
+    }
+
+    bool operator==(const PuzzleProfile & in) const {
+      return num_steps == in.num_steps && solved == in.solved && solution_count == in.solution_count
+        && std::equal(GetSteps(), GetSteps() + num_steps, in.GetSteps());
+    }
+    bool operator!=(const PuzzleProfile & in) const { return !(*this == in); }
+
+    // A 64-bit hash of the steps, solved flag, and solution count.
+    uint64_t GetHash() const {
+      uint64_t hash = Mix((uint64_t) num_steps | ((uint64_t) (uint32_t) solution_count << 32) | (solved ? 1ull << 31 : 0));
+      const uint16_t * steps = GetSteps();
+      int i = 0;
+      for (; i + 4 <= num_steps; i += 4) {      // Four steps per word.
+        uint64_t word;
+        std::memcpy(&word, steps + i, sizeof(word));
+        hash = Mix(hash ^ word);
+      }
+      uint64_t tail = 0;
+      for (int j = 0; i < num_steps; i++, j++) tail |= (uint64_t) steps[i] << (16 * j);
+      return Mix(hash ^ tail);
+    }
+
+    // How far is this profile from a target solving experience?  Steps are compared in
+    // order: each costs LEVEL_WEIGHT per level of difference plus one per move of
+    // difference, and steps past the end of the shorter profile are compared against an
+    // empty step.  The loops are flat and branch-free, so they vectorize.
+    int Distance(const PuzzleProfile & target) const {
+      const uint16_t * steps = GetSteps();
+      const uint16_t * target_steps = target.GetSteps();
+      const int common = std::min(num_steps, target.num_steps);
+      int total = 0;
+      for (int i = 0; i < common; i++) total += StepDistance(steps[i], target_steps[i]);
+      for (int i = common; i < num_steps; i++) total += StepDistance(steps[i], 0);
+      for (int i = common; i < target.num_steps; i++) total += StepDistance(0, target_steps[i]);
+      return total;
     }
 
     void Print(std::ostream & out=std::cout) const {
-      for (int i = 0; i < (int) levels.size(); i++) {
-        out << levels[i] << ":" << counts[i] << " ";
+      for (int i = 0; i < num_steps; i++) {
+        out << GetLevel(i) << ":" << GetCount(i) << " ";
       }
       out << std::endl;
     }
@@ -0,0 +1,149 @@
+//  This file is part of PuzzleEngine, https://github.com/mercere99/PuzzleEngine/
+//  Copyright (C) Michigan State University, 2015.
+//  Released under the MIT Software license; see doc/LICENSE
+//
+//
+//  A solving ladder fixed at compile time.
+//
+//  SolveLadder<TECHS...> tries each technique in turn, easiest first; whenever one makes
+//  progress it applies the moves, records them in the profile, and restarts from the
+//  bottom rung.  The rungs are a template parameter pack, so the whole ladder is unrolled
+//  into straight-line calls with no virtual dispatch.
+//
+//  A technique is any type providing:
+//    static constexpr int LEVEL;          // Level recorded in the profile for its moves.
+//    static constexpr const char * NAME;  // For reporting.
+//    static void Find(STATE_T & state, MoveBuffer & moves);   // Add moves found.
+//
+//  The state type must provide Move(MoveBuffer), IsSolved(), and HasContradiction().
+//  One MoveBuffer on the stack is reused by every rung, so climbing the ladder does not
+//  allocate.  The ladder stops as soon as the state is solved or has reached a
+//  contradiction (an unset cell with no options left), or when no rung makes progress.
+//
+//  Passing a Stats object to Run() counts, for each rung, how often it was tried, how
+//  often it found moves, how many moves it found, and the time spent in it.  Without one,
+//  no counting or timing is done.
+
+#ifndef PZE_SOLVE_LADDER_H
+#define PZE_SOLVE_LADDER_H
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <utility>
+#include <vector>
+#include "MoveBuffer.h"
+#include "Puzzle.h"
+#include "SolveStats.h"
+
+namespace pze {
+
+  // Counters for a single rung of a ladder.
+  struct TechniqueStats {
+    uint64_t calls = 0;    // Times the technique was tried.
+    uint64_t hits = 0;     // Times it found at least one move.
+    uint64_t moves = 0;    // Total moves found.
+    uint64_t ns = 0;       // Total time spent looking, in nanoseconds.
+
+    TechniqueStats & operator+=(const TechniqueStats & in) {
+      calls += in.calls;
+      hits += in.hits;
+      moves += in.moves;
+      ns += in.ns;
+      return *this;
+    }
+  };
+
+  template <typename... TECHS>
+  class SolveLadder {
+  public:
+    static constexpr int NUM_RUNGS = (int) sizeof...(TECHS);
+
+    // Counters for every rung of this ladder, plus how many runs ended in a contradiction.
+    struct Stats {
+      std::array<TechniqueStats, NUM_RUNGS> rungs;
+      uint64_t runs = 0;
+      uint64_t contradictions = 0;
+
+      Stats & operator+=(const Stats & in) {
+        for (int i = 0; i < NUM_RUNGS; i++) rungs[i] += in.rungs[i];
+        runs += in.runs;
+        contradictions += in.contradictions;
+        return *this;
+      }
+
+      void Clear() { *this = Stats(); }
+
+      void Print(std::ostream & out=std::cout) const {
+        out << "technique, calls, hits, moves, ns, ns_per_call" << std::endl;
+        for (int i = 0; i < NUM_RUNGS; i++) {
+          const TechniqueStats & rung = rungs[i];
+          out << names[i] << ", " << rung.calls << ", " << rung.hits << ", " << rung.moves
+              << ", " << rung.ns << ", " << (rung.calls ? (double) rung.ns / rung.calls : 0.0)
+              << std::endl;
+        }
+        out << "runs=" << runs << " contradictions=" << contradictions << std::endl;
+      }
+    };
+
+    static constexpr std::array<const char *, NUM_RUNGS> names = { TECHS::NAME... };
+    static constexpr std::array<int, NUM_RUNGS> levels = { TECHS::LEVEL... };
+
+  private:
+    // Try a single rung; return true if it made progress.
+    template <typename TECH, int RUNG, typename STATE_T>
+    static bool TryRung(STATE_T & state, PuzzleProfile & profile, MoveBuffer & moves, Stats * stats) {
+      std::chrono::steady_clock::time_point start_time;
+      if (stats) start_time = std::chrono::steady_clock::now();
+
+      moves.Clear();
+      TECH::Find(state, moves);
+      static_assert(TECH::LEVEL >= 0 && TECH::LEVEL < SolveCounters::NUM_LEVELS);
+      PZE_STAT(technique_calls[TECH::LEVEL]++);
+      PZE_STAT(technique_hits[TECH::LEVEL] += !moves.IsEmpty());
+
+      if (stats) {
+        TechniqueStats & rung = stats->rungs[RUNG];
+        rung.ns += std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now() - start_time).count();
+        rung.calls++;
+        rung.hits += !moves.IsEmpty();
+        rung.moves += moves.GetSize();
+      }
+
+      if (moves.IsEmpty()) return false;
+      state.Move(moves);
+      profile.AddMoves(TECH::LEVEL, moves.GetSize());
+      return true;
+    }
+
+    // Try the rungs in order, stopping at the first one that makes progress.
+    template <typename STATE_T, int... RUNGS>
+    static bool Step(STATE_T & state, PuzzleProfile & profile, MoveBuffer & moves, Stats * stats,
+                     std::integer_sequence<int, RUNGS...>) {
+      return (TryRung<TECHS, RUNGS>(state, profile, moves, stats) || ...);
+    }
+
+  public:
+    // Climb the ladder until the state is solved, contradictory, or stuck.
+    // Return false if the ladder stopped on a contradiction.
+    template <typename STATE_T>
+    static bool Run(STATE_T & state, PuzzleProfile & profile, Stats * stats=nullptr) {
+      if (stats) stats->runs++;
+      MoveBuffer moves;
+      while (true) {
+        if (state.HasContradiction()) {
+          if (stats) stats->contradictions++;
+          return false;
+        }
+        if (state.IsSolved()) return true;
+        const auto rungs = std::make_integer_sequence<int, NUM_RUNGS>();
+        if (!Step(state, profile, moves, stats, rungs)) return true;
+      }
+    }
+  };
+
+}
+
+#endif
@@ -0,0 +1,194 @@
+//  This file is part of PuzzleEngine, https://github.com/mercere99/PuzzleEngine/
+//  Copyright (C) Michigan State University, 2015.
+//  Released under the MIT Software license; see doc/LICENSE
+//
+//
+//  Counters for the solver's inner loops, compiled in only when PZE_STATS is defined.
+//
+//  Each thread counts into its own (thread_local) counters, so counting never touches
+//  shared cache lines.  Only the owning thread ever writes them; they are relaxed atomics
+//  so that solve_stats::Snapshot() may read them from another thread at any time, and an
+//  increment is still a plain load and store.  Snapshot() adds up every thread's counters
+//  (including threads that have since exited).  solve_stats::Reset() does not write other
+//  threads' counters; it records where each one stands and Snapshot() counts from there.
+//  Work still in progress during either call may land on either side of it.
+//
+//  Use as PZE_STAT(set_calls++), naming a field of SolveCounters.  SudokuBatch counts its
+//  technique runs just as the scalar ladder would, but its lanes update options directly,
+//  so their work does not show up in set_calls or block_clears.
+//  Without PZE_STATS, PZE_STAT() expands to nothing and no thread_local storage exists,
+//  so the solver compiles to exactly the same code as before.
+
+#ifndef PZE_SOLVE_STATS_H
+#define PZE_SOLVE_STATS_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace pze {
+
+  struct SolveCounters {
+    static constexpr int NUM_LEVELS = 16;   // One slot per PuzzleProfile level.
+
+    uint64_t set_calls = 0;        // SudokuState::Set() calls that set a new value.
+    uint64_t block_clears = 0;     // SudokuState::Block() calls that removed an option.
+    uint64_t search_branches = 0;  // States tried at branch points of ForceSolve() & co.
+    uint64_t search_backtracks = 0;// Branch points abandoned after running out of states.
+    std::array<uint64_t, NUM_LEVELS> technique_calls{};   // Technique runs, by level.
+    std::array<uint64_t, NUM_LEVELS> technique_hits{};    // ...and those that found moves.
+
+    SolveCounters & operator+=(const SolveCounters & in) {
+      set_calls += in.set_calls;
+      block_clears += in.block_clears;
+      search_branches += in.search_branches;
+      search_backtracks += in.search_backtracks;
+      for (int i = 0; i < NUM_LEVELS; i++) {
+        technique_calls[i] += in.technique_calls[i];
+        technique_hits[i] += in.technique_hits[i];
+      }
+      return *this;
+    }
+
+    SolveCounters & operator-=(const SolveCounters & in) {
+      set_calls -= in.set_calls;
+      block_clears -= in.block_clears;
+      search_branches -= in.search_branches;
+      search_backtracks -= in.search_backtracks;
+      for (int i = 0; i < NUM_LEVELS; i++) {
+        technique_calls[i] -= in.technique_calls[i];
+        technique_hits[i] -= in.technique_hits[i];
+      }
+      return *this;
+    }
+
+    // One CSV line, prefixed by label (e.g., a generation number); see PrintHeader().
+    static void PrintHeader(std::ostream & out=std::cout) {
+      out << "label, set_calls, block_clears, search_branches, search_backtracks";
+      for (int i = 0; i < NUM_LEVELS; i++) out << ", calls_" << i << ", hits_" << i;
+      out << std::endl;
+    }
+    void Print(const std::string & label, std::ostream & out=std::cout) const {
+      out << label << ", " << set_calls << ", " << block_clears
+          << ", " << search_branches << ", " << search_backtracks;
+      for (int i = 0; i < NUM_LEVELS; i++) out << ", " << technique_calls[i] << ", " << technique_hits[i];
+      out << std::endl;
+    }
+  };
+
+#ifdef PZE_STATS
+  namespace solve_stats {
+
+    // A counter written only by its own thread, but safe for any thread to read.
+    class Counter {
+    private:
+      std::atomic<uint64_t> value{0};
+
+    public:
+      void operator++(int) { *this += 1; }
+      void operator+=(uint64_t amount) {
+        value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+      }
+      uint64_t Get() const { return value.load(std::memory_order_relaxed); }
+    };
+
+    // The live form of SolveCounters, with the same field names so PZE_STAT() reads the same.
+    struct LiveCounters {
+      Counter set_calls;
+      Counter block_clears;
+      Counter search_branches;
+      Counter search_backtracks;
+      std::array<Counter, SolveCounters::NUM_LEVELS> technique_calls;
+      std::array<Counter, SolveCounters::NUM_LEVELS> technique_hits;
+
+      SolveCounters Load() const {
+        SolveCounters out;
+        out.set_calls = set_calls.Get();
+        out.block_clears = block_clears.Get();
+        out.search_branches = search_branches.Get();
+        out.search_backtracks = search_backtracks.Get();
+        for (int i = 0; i < SolveCounters::NUM_LEVELS; i++) {
+          out.technique_calls[i] = technique_calls[i].Get();
+          out.technique_hits[i] = technique_hits[i].Get();
+        }
+        return out;
+      }
+    };
+
+    struct ThreadCounters;
+
+    // Every live thread's counters, plus the totals of threads that have exited.
+    struct Registry {
+      std::mutex mutex;
+      std::vector<ThreadCounters *> live;
+      SolveCounters retired;
+    };
+    inline Registry & GetRegistry() {
+      static Registry registry;
+      return registry;
+    }
+
+    // A thread's counters register themselves on first use and fold into the retired
+    // totals when the thread exits.  base (guarded by the registry mutex) is where the
+    // counters stood at the last Reset().
+    struct ThreadCounters {
+      LiveCounters counters;
+      SolveCounters base;
+
+      SolveCounters Count() const { SolveCounters out = counters.Load(); out -= base; return out; }
+
+      ThreadCounters() {
+        Registry & registry = GetRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.live.push_back(this);
+      }
+      ~ThreadCounters() {
+        Registry & registry = GetRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.retired += Count();
+        std::erase(registry.live, this);
+      }
+    };
+
+    inline LiveCounters & Local() {
+      thread_local ThreadCounters local;
+      return local.counters;
+    }
+
+    // Totals over all threads since the last Reset().
+    inline SolveCounters Snapshot() {
+      Registry & registry = GetRegistry();
+      std::lock_guard<std::mutex> lock(registry.mutex);
+      SolveCounters total = registry.retired;
+      for (const ThreadCounters * thread : registry.live) total += thread->Count();
+      return total;
+    }
+
+    inline void Reset() {
+      Registry & registry = GetRegistry();
+      std::lock_guard<std::mutex> lock(registry.mutex);
+      registry.retired = SolveCounters();
+      for (ThreadCounters * thread : registry.live) thread->base = thread->counters.Load();
+    }
+
+    inline constexpr bool IsEnabled() { return true; }
+  }
+
+  #define PZE_STAT(EXPR) (::pze::solve_stats::Local().EXPR)
+#else
+  namespace solve_stats {
+    inline SolveCounters Snapshot() { return SolveCounters(); }
+    inline void Reset() { ; }
+    inline constexpr bool IsEnabled() { return false; }
+  }
+
+  #define PZE_STAT(EXPR) ((void) 0)
+#endif
+
+}
+
+#endif
@@ -0,0 +1,207 @@
+//  This file is part of PuzzleEngine, https://github.com/mercere99/PuzzleEngine/
+//  Copyright (C) Michigan State University, 2015.
+//  Released under the MIT Software license; see doc/LICENSE
+//
+//
+//  Asynchronous steady-state evolution, with no generation barriers.
+//
+//  Every worker repeats: pick a parent by tournament, copy it, mutate and evaluate the
+//  copy, and insert it back into the shared population, either over the current worst
+//  organism or over the loser of a small replacement tournament (in both cases only if
+//  the child is at least as fit).  Only picking and inserting hold the population's lock;
+//  mutation and evaluation, where nearly all of the time goes, run unlocked, so a slow
+//  evaluation on one thread never holds up the others.
+//
+//  Each worker has its own emp::Random, seeded from the master generator when Run()
+//  starts.  With one worker, runs are reproducible; with several, the order in which
+//  children are inserted depends on timing, so results vary from run to run.
+//
+//  Run() can report progress without adding a barrier: the worker whose child completes
+//  each multiple of the progress interval calls the progress function itself, while it
+//  still holds the lock it counted that child under, so reports arrive in order.
+//
+//  For Replace::WORST, the population keeps a min-heap of (fitness, id) during Run(), so
+//  finding the worst organism is O(1) and replacing it O(log N), rather than a scan of
+//  the whole population under the lock on every birth.
+
+#ifndef PZE_STEADY_STATE_H
+#define PZE_STEADY_STATE_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+#include "base/assert.hpp"
+#include "math/Random.hpp"
+#include "ThreadPool.h"
+
+namespace pze {
+
+  template <typename ORG>
+  class SteadyStatePopulation {
+  public:
+    using fit_fun_t = std::function<double(ORG*)>;
+    using mut_fun_t = std::function<void(ORG&, emp::Random&)>;
+    using progress_fun_t = std::function<void(size_t num_done, double best_fit)>;
+
+    enum class Replace { WORST, TOURNAMENT };
+
+    // Totals from the most recent Run().
+    struct RunStats {
+      size_t evaluations = 0;
+      size_t replacements = 0;      // Children that made it into the population.
+      double seconds = 0.0;
+      double GetEvalsPerSec() const { return seconds > 0.0 ? evaluations / seconds : 0.0; }
+    };
+
+  private:
+    std::vector<ORG> pop;
+    std::vector<double> fitness;      // Cached fitness of each organism.
+    std::vector<std::pair<double,int>> worst_heap;   // Min-heap of (fitness, id), for WORST.
+    std::mutex mutex;                 // Guards pop, fitness, and worst_heap.
+
+    fit_fun_t fit_fun;                // Must evaluate (and cache) an organism's fitness.
+    mut_fun_t mut_fun;
+    int select_size;                  // Tournament size for picking parents.
+    Replace replace;
+    int replace_size;                 // Tournament size for Replace::TOURNAMENT.
+    RunStats stats;
+
+    // Shared by the workers of a single Run().
+    struct RunState {
+      std::atomic<size_t> budget;       // Evaluations not yet claimed by a worker.
+      std::atomic<size_t> done;         // Children evaluated and offered to the population.
+      std::atomic<size_t> replaced;
+      size_t num_evals;
+      size_t progress_interval;         // 0 for no progress reports.
+      const progress_fun_t & progress_fun;
+
+      RunState(size_t in_num_evals, size_t in_interval, const progress_fun_t & in_progress_fun)
+        : budget(in_num_evals), done(0), replaced(0), num_evals(in_num_evals)
+        , progress_interval(in_progress_fun ? in_interval : 0), progress_fun(in_progress_fun) { ; }
+    };
+
+    // Draw a positive seed for a new stream.
+    static int NextSeed(emp::Random & random) { return 1 + (int) (random.GetUInt() >> 2); }
+
+    // Pick a parent by tournament and copy it out (lock held).
+    ORG PickParent(emp::Random & random) const {
+      int best_id = (int) random.GetUInt(pop.size());
+      for (int i = 1; i < select_size; i++) {
+        const int id = (int) random.GetUInt(pop.size());
+        if (fitness[id] > fitness[best_id]) best_id = id;
+      }
+      return pop[best_id];
+    }
+
+    // Choose which organism a child would replace (lock held).  For WORST, ties go to the
+    // lowest id, as a scan would pick.
+    int PickVictim(emp::Random & random) const {
+      if (replace == Replace::WORST) return worst_heap.front().second;
+      int worst_id = (int) random.GetUInt(pop.size());
+      for (int i = 1; i < replace_size; i++) {
+        const int id = (int) random.GetUInt(pop.size());
+        if (fitness[id] < fitness[worst_id]) worst_id = id;
+      }
+      return worst_id;
+    }
+
+    // One worker: breed children until the shared evaluation budget runs out.
+    void Work(emp::Random & random, RunState & run) {
+      while (true) {
+        size_t left = run.budget.load(std::memory_order_relaxed);
+        do {
+          if (left == 0) return;
+        } while (!run.budget.compare_exchange_weak(left, left - 1, std::memory_order_relaxed));
+
+        ORG child = [this, &random]{
+          std::lock_guard<std::mutex> lock(mutex);
+          return PickParent(random);
+        }();
+        mut_fun(child, random);
+        const double child_fit = fit_fun(&child);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        const int victim = PickVictim(random);
+        if (child_fit >= fitness[victim]) {
+          pop[victim] = std::move(child);
+          fitness[victim] = child_fit;
+          if (replace == Replace::WORST) {
+            std::pop_heap(worst_heap.begin(), worst_heap.end(), std::greater<>());
+            worst_heap.back() = { child_fit, victim };
+            std::push_heap(worst_heap.begin(), worst_heap.end(), std::greater<>());
+          }
+          run.replaced.fetch_add(1, std::memory_order_relaxed);
+        }
+        const size_t num_done = run.done.fetch_add(1, std::memory_order_relaxed) + 1;
+        if (run.progress_interval == 0) continue;
+        if (num_done % run.progress_interval != 0 && num_done != run.num_evals) continue;
+        run.progress_fun(num_done, fitness[GetBestID()]);
+      }
+    }
+
+  public:
+    SteadyStatePopulation(fit_fun_t in_fit_fun, mut_fun_t in_mut_fun, int in_select_size=4,
+                          Replace in_replace=Replace::WORST, int in_replace_size=4)
+      : fit_fun(in_fit_fun), mut_fun(in_mut_fun), select_size(in_select_size)
+      , replace(in_replace), replace_size(in_replace_size) { ; }
+    SteadyStatePopulation(const SteadyStatePopulation &) = delete;
+    ~SteadyStatePopulation() { ; }
+    SteadyStatePopulation & operator=(const SteadyStatePopulation &) = delete;
+
+    int GetSize() const { return (int) pop.size(); }
+    const ORG & operator[](int id) const { return pop[id]; }
+    double GetFitness(int id) const { return fitness[id]; }
+    const RunStats & GetStats() const { return stats; }
+
+    // Add copies of an organism (not while Run() is in progress).
+    void Insert(const ORG & org, int copy_count=1) {
+      ORG copy(org);
+      const double fit = fit_fun(&copy);
+      for (int i = 0; i < copy_count; i++) {
+        pop.push_back(copy);
+        fitness.push_back(fit);
+      }
+    }
+
+    // Produce num_evals children, using every thread in the pool as a worker.  If given,
+    // progress_fun is called (from a worker thread) after every progress_interval children
+    // and after the last one, with the number done so far and the best fitness.  It runs
+    // with the population locked, so it should be quick (e.g., print a line).
+    void Run(size_t num_evals, emp::Random & random, ThreadPool & pool,
+             size_t progress_interval=0, const progress_fun_t & progress_fun=nullptr) {
+      emp_assert(pop.size() > 0);
+      const size_t num_workers = pool.GetNumThreads();
+      std::vector<std::unique_ptr<emp::Random>> worker_random;
+      for (size_t i = 0; i < num_workers; i++) worker_random.push_back(std::make_unique<emp::Random>(NextSeed(random)));
+
+      worst_heap.clear();
+      if (replace == Replace::WORST) {
+        for (int id = 0; id < (int) pop.size(); id++) worst_heap.emplace_back(fitness[id], id);
+        std::make_heap(worst_heap.begin(), worst_heap.end(), std::greater<>());
+      }
+
+      RunState run(num_evals, progress_interval, progress_fun);
+      const auto start_time = std::chrono::steady_clock::now();
+      pool.ParallelFor(num_workers, [this, &worker_random, &run](size_t id){
+          Work(*worker_random[id], run);
+        }, 1);
+
+      stats.evaluations = num_evals;
+      stats.replacements = run.replaced.load();
+      stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    }
+
+    // The id of the fittest organism (ties favor the earlier one).
+    int GetBestID() const {
+      return (int) (std::max_element(fitness.begin(), fitness.end()) - fitness.begin());
+    }
+  };
+
+}
+
+#endif
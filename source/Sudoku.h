@@ -17,17 +17,37 @@
 #include <istream>
 #include <set>
 #include <vector>
-#include <map>
 #include "base/assert.hpp"
 #include "math/Random.hpp"
 #include "math/random_utils.hpp"
 #include "tools/string_utils.hpp"
+#include "CellMask.h"
+#include "MoveBuffer.h"
+#include "ProfileCache.h"
 #include "Puzzle.h"
+#include "SolveLadder.h"
+#include "SudokuSIMD.h"
 
 namespace pze {
 
   class Sudoku : public Puzzle {
   public: 
+    // Levels recorded in a PuzzleProfile, one for each solving technique, in the order
+    // that the CalcProfile() ladder tries them.
+    enum SolveLevel {
+      LEVEL_LAST_CELL = 0,     // Naked singles
+      LEVEL_LAST_REGION,       // Hidden singles
+      LEVEL_NAKED_PAIR,
+      LEVEL_HIDDEN_PAIR,
+      LEVEL_NAKED_TRIPLE,
+      LEVEL_HIDDEN_TRIPLE,
+      LEVEL_NAKED_QUAD,
+      LEVEL_HIDDEN_QUAD,
+      LEVEL_XWING,             // Fish with two base lines
+      LEVEL_SWORDFISH,         // Fish with three base lines
+      LEVEL_JELLYFISH          // Fish with four base lines
+    };
+
     class SudokuState : public PuzzleState {
     public:
       using PuzzleState::Move;
@@ -45,6 +65,12 @@ namespace pze {
       std::array<uint32_t, NUM_CELLS> options;  // Options still available to each cell
       const Sudoku* puzzle;                    // Pointer back to original puzzle
 
+      // Track which cells and regions have changed since they were last scanned by a
+      // technique, so that repeated scans can skip the parts of the board that did not move.
+      CellMask dirty_cells;                     // Cells whose options changed
+      uint32_t dirty_regions;                   // Regions (one bit each) containing a changed cell
+      bool contradiction;                       // Has an unset cell run out of options (or a Set() failed)?
+
       // "members" tracks which cell ids are members of each region.
       static constexpr int members[NUM_REGIONS][9] = {
         // Rows (Overlaps: 111000000, 000111000, 000000111)
@@ -351,6 +377,196 @@ namespace pze {
       //   { 17, 20 }, { 17, 23 }, { 17, 26 }
       // };
       
+      // Which states are available in exactly one cell of a region?
+      uint32_t CalcRegionOnce(int region_id) const {
+        uint32_t opt_any = 0;     // Is a state an option in ANY cell?
+        uint32_t opt_multi = 0;   // Is a state an option in MULTIPLE cells?
+        for (const int c : members[region_id]) {
+          opt_multi |= (options[c] & opt_any);  // If we already had an option AND see a new one.
+          opt_any |= options[c];                // Mark these options as possible.
+        }
+        return opt_any & ~opt_multi;
+      }
+
+      // Add a SET move for each cell in a region holding one of the opt_once states.
+      void AddLastRegionStates(int region_id, uint32_t opt_once, MoveBuffer & moves) const {
+        for (const int c : members[region_id]) {
+          const uint32_t opt_unique = options[c] & opt_once;
+          if (opt_unique) {
+            moves.AddSet(c, next_opt[opt_unique]);
+          }
+        }
+      }
+
+      // Below this many regions to scan, a scalar loop beats a full vectorized pass.
+      static constexpr int SIMD_MIN_REGIONS = 8;
+
+      // --- Helpers for the brute-force search ---
+
+      // A single change recorded on the undo trail: a cell's value and options before it changed.
+      struct TrailEntry {
+        uint8_t cell;
+        char value;
+        uint16_t options;
+      };
+
+      // A branch point: the cell being tried, which of its states are left to try, and the
+      // trail size to roll back to before each attempt.
+      struct SearchFrame {
+        int cell;
+        uint32_t untried;
+        int trail_mark;
+      };
+
+      struct SearchData {
+        // Changes along any search path are bounded: each cell can be set once and can
+        // lose each of its nine options once.
+        std::array<TrailEntry, NUM_CELLS * (NUM_STATES+1)> trail;
+        std::array<SearchFrame, NUM_CELLS> frames;
+        std::array<uint8_t, NUM_CELLS> singles;       // Cells newly down to a single option.
+        int trail_size = 0;
+        int num_frames = 0;
+        int num_singles = 0;
+      };
+
+      void Record(SearchData & data, int cell) {
+        data.trail[data.trail_size++] = { (uint8_t) cell, value[cell], (uint16_t) options[cell] };
+      }
+
+      // Roll back all changes made after the trail was at the given size.
+      void Undo(SearchData & data, int trail_mark) {
+        while (data.trail_size > trail_mark) {
+          const TrailEntry & entry = data.trail[--data.trail_size];
+          value[entry.cell] = entry.value;
+          options[entry.cell] = entry.options;
+        }
+        data.num_singles = 0;
+      }
+
+      // Set a cell during search, recording every change made.  Return false on contradiction.
+      bool Assign(SearchData & data, int cell, int state) {
+        Record(data, cell);
+        value[cell] = state;
+        options[cell] = 0;
+        const uint32_t bit = 1 << state;
+        for (int id : links[cell]) {
+          if ((options[id] & bit) == 0) continue;
+          Record(data, id);
+          options[id] &= ~bit;
+          const int count = opts_count[options[id]];
+          if (count == 0) return false;               // Unset cell with no options left!
+          if (count == 1) data.singles[data.num_singles++] = (uint8_t) id;
+        }
+        return true;
+      }
+
+      // Lock in all naked and hidden singles until none remain.  Return false on contradiction.
+      bool Propagate(SearchData & data, bool scan_cells=false) {
+        if (scan_cells) {
+          data.num_singles = 0;
+          for (int cell = 0; cell < NUM_CELLS; cell++) {
+            if (value[cell] != -1) continue;
+            if (options[cell] == 0) return false;
+            if (opts_count[options[cell]] == 1) data.singles[data.num_singles++] = (uint8_t) cell;
+          }
+        }
+
+        bool progress = true;
+        while (progress) {
+          // Naked singles: a cell with only one option left.
+          while (data.num_singles > 0) {
+            const int cell = data.singles[--data.num_singles];
+            if (value[cell] != -1) continue;          // Already handled.
+            if (!Assign(data, cell, next_opt[options[cell]])) return false;
+          }
+
+          // Hidden singles: a state with only one possible cell left in a region.
+          progress = false;
+          for (const auto & region : members) {
+            uint32_t opt_any = 0, opt_multi = 0, placed = 0;
+            for (const int c : region) {
+              opt_multi |= options[c] & opt_any;
+              opt_any |= options[c];
+              if (value[c] != -1) placed |= 1 << value[c];
+            }
+            if ((opt_any | placed) != 511) return false;   // Some state has nowhere to go!
+            uint32_t opt_once = opt_any & ~opt_multi;
+            if (opt_once == 0) continue;
+            for (const int c : region) {
+              const uint32_t opt_unique = options[c] & opt_once;
+              if (opt_unique == 0) continue;
+              if (opt_unique & (opt_unique - 1)) return false;  // Cell needs two states!
+              if (!Assign(data, c, next_opt[opt_unique])) return false;
+              progress = true;
+            }
+            if (data.num_singles) break;              // Handle naked singles first.
+          }
+          if (data.num_singles) progress = true;
+        }
+        return true;
+      }
+
+      // Find the unset cell with the fewest options (or -1 if all cells are set).
+      int FindMostConstrained() const {
+        int best_cell = -1;
+        int best_count = NUM_STATES + 1;
+        for (int cell = 0; cell < NUM_CELLS; cell++) {
+          if (value[cell] != -1) continue;
+          const int count = opts_count[options[cell]];
+          if (count < best_count) {
+            best_cell = cell;
+            best_count = count;
+            if (count <= 2) break;                    // Can't do better after propagation.
+          }
+        }
+        return best_cell;
+      }
+
+      // Try the next untried state at the deepest branch point, backtracking to earlier
+      // branch points as they run out.  Return false if every branch has been exhausted.
+      // States are tried in order, or in random order if random is given.
+      bool NextBranch(SearchData & data, emp::Random * random) {
+        while (data.num_frames > 0) {
+          SearchFrame & frame = data.frames[data.num_frames-1];
+          Undo(data, frame.trail_mark);
+          if (frame.untried == 0) {
+            PZE_STAT(search_backtracks++);
+            data.num_frames--;
+            continue;
+          }
+          uint32_t pick = frame.untried;
+          if (random) {
+            for (int skip = (int) random->GetUInt(opts_count[pick]); skip > 0; skip--) pick &= pick - 1;
+          }
+          const int state = next_opt[pick];
+          frame.untried &= ~(1u << state);
+          PZE_STAT(search_branches++);
+          if (Assign(data, frame.cell, state) && Propagate(data)) return true;
+        }
+        return false;
+      }
+
+      // Search for up to limit solutions.  If keep_solution is set and a solution is found,
+      // leave it in place; otherwise restore the original state before returning.
+      int RunSearch(int limit, bool keep_solution, emp::Random * random=nullptr) {
+        SearchData data;
+        int found = 0;
+        bool ok = !contradiction && Propagate(data, true);
+        while (ok) {
+          const int cell = FindMostConstrained();
+          if (cell == -1) {                                 // All cells are set; a solution!
+            if (++found >= limit) break;
+            ok = NextBranch(data, random);
+            continue;
+          }
+          data.frames[data.num_frames++] = { cell, options[cell], data.trail_size };
+          ok = NextBranch(data, random);
+        }
+
+        if (!keep_solution || found == 0) Undo(data, 0);
+        return found;
+      }
+
     public:
       SudokuState(const Sudoku * p) : puzzle(p) { Clear(); }
       SudokuState(const Sudoku & p) : puzzle(&p) { Clear(); }
@@ -361,6 +577,7 @@ namespace pze {
 
       int GetValue(int cell) const { return value[cell]; }
       uint32_t GetOptions(int cell) const { return options[cell]; }
+      const std::array<uint32_t, NUM_CELLS> & GetOptionsArray() const { return options; }
       int CountOptions(int cell) const {
         // if (cell < 0 || cell >= 81) std::cout << "cell=" << cell << std::endl;
         emp_assert(cell >= 0 && cell < 81, cell);
@@ -373,6 +590,7 @@ namespace pze {
         return options[cell] & (1 << state);
       }
       bool IsSet(int cell) const { return value[cell] != -1; }
+      bool HasContradiction() const { return contradiction; }
       bool IsSolved() {
         for (uint32_t o : options) if (o) return false;  // (o) checks if the value of o is non-zero
         return true;
@@ -382,29 +600,59 @@ namespace pze {
       void Clear() override{
         value.fill(-1);
         options.fill(511);  // Set all options to one.  or 0b111111111
+        contradiction = false;
+        MarkAllDirty();
+      }
+
+      // Note that a cell's options have changed (along with the three regions it is in).
+      void MarkDirty(int cell) {
+        dirty_cells.Set(cell);
+        dirty_regions |= (1u << regions[cell][0]) | (1u << regions[cell][1]) | (1u << regions[cell][2]);
+      }
+
+      // Force the next dirty-only scans to look at the whole board.
+      void MarkAllDirty() {
+        dirty_cells = CellMask::Range(NUM_CELLS);
+        dirty_regions = (1u << NUM_REGIONS) - 1;
       }
 
+      const CellMask & GetDirtyCells() const { return dirty_cells; }
+      uint32_t GetDirtyRegions() const { return dirty_regions; }
+
       // Find the next available option for a cell.
       int FindNext(int cell) { return next_opt[options[cell]]; }
 
-      // Set the value of an individual cell; remove option from linked cells.
-      // Return true/false based on whether progress was made toward solving the puzzle.
+      // Set the value of an individual cell; remove option from linked cells.  Setting a
+      // state that has been ruled out (such as a given that repeats a peer's) is a
+      // contradiction, and leaves the cell as it was.
       void Set(int cell, int state) override{
         emp_assert(cell >= 0 && cell < NUM_CELLS);    // Make sure cell is in a valid range.
         emp_assert(state >= 0 && state < NUM_STATES); // Make sure state is in a valid range.
 
         if (value[cell] == state) return;      // If state is already set, SKIP!
+        if (!HasOption(cell,state)) {
+          contradiction = true;
+          return;
+        }
 
-        emp_assert(HasOption(cell,state));     // Make sure state is allowed.
+        PZE_STAT(set_calls++);
         value[cell] = state;                   // Store found value!
         options[cell] = 0;                     // No options available to locked cells.
+        MarkDirty(cell);
         
         // Now make sure this state is blocked from all linked cells.
         for (int id : links[cell]) Block(id, state);
       }
       
       // Remove a symbol option from a particular cell.
-      void Block(int cell, int state) override { options[cell] &= ~(1 << state); }
+      void Block(int cell, int state) override {
+        const uint32_t bit = 1 << state;
+        if ((options[cell] & bit) == 0) return;  // Already blocked; nothing changes.
+        PZE_STAT(block_clears++);
+        options[cell] &= ~bit;
+        MarkDirty(cell);
+        if (options[cell] == 0 && value[cell] == -1) contradiction = true;
+      }
 
       // Operate on a "move" object.
       void Move(const PuzzleMove & move) override{
@@ -419,6 +667,15 @@ namespace pze {
         }
       }
       
+      // Apply a whole buffer of moves.  (Calls are resolved here rather than through the
+      // virtual Set() and Block(), since this is the solving ladder's inner loop.)
+      void Move(const MoveBuffer & moves) {
+        for (const PackedMove move : moves) {
+          if (move.IsSet()) SudokuState::Set(move.GetID(), move.GetState());
+          else SudokuState::Block(move.GetID(), move.GetState());
+        }
+      }
+
       // Print the current state of the puzzle, including all options available.
       void Print(const std::array<char,9> & symbols, std::ostream & out=std::cout){
         out << " +-----------------------+-----------------------+-----------------------+"
@@ -458,9 +715,9 @@ namespace pze {
         Print(puzzle->GetSymbols(), out);
       }
 
-      // Use a brute-force approach to completely solve this puzzle.
-      // Return true if solved, false if unsolvable.
-      bool ForceSolve(int start=0){
+      // Use a brute-force approach to completely solve this puzzle, trying cells in order.
+      // Return true if solved, false if unsolvable.  (ForceSolve() is usually much faster.)
+      bool ForceSolve_Recursive(int start=0){
         emp_assert(start >= 0 && start <= NUM_CELLS);
         
         // Advance the start position until we find a cell with a choice to be made.
@@ -482,7 +739,7 @@ namespace pze {
           
           SudokuState backup_state(*this);    // backup the current state.
           Set(start, i);                      // set this cell to next possible value.
-          bool solved = ForceSolve(start+1);  // continue attempt to solve!
+          bool solved = ForceSolve_Recursive(start+1);  // continue attempt to solve!
           if (solved) return true;            // if solved, we're done!
           *this = backup_state;               // otherwise, restore from backup and loop.
         }
@@ -491,200 +748,357 @@ namespace pze {
         return false;
       }
 
+      // Use a brute-force search to completely solve this puzzle.  Branches on the cell
+      // with the fewest options, propagates naked and hidden singles after every choice,
+      // and undoes failed branches from a trail of changes rather than full copies.
+      // Return true if solved; if unsolvable, return false and leave the state unchanged.
+      bool ForceSolve(){
+        const bool solved = (RunSearch(1, true) == 1);
+        MarkAllDirty();
+        return solved;
+      }
+
+      // Fill in a random solution: the same search as ForceSolve(), but each branch point
+      // tries its states in random order.  Return false (leaving the state unchanged) if
+      // there is no solution.
+      bool RandomSolve(emp::Random & random){
+        const bool solved = (RunSearch(1, true, &random) == 1);
+        MarkAllDirty();
+        return solved;
+      }
+
+      // Count the solutions reachable from this state, stopping as soon as limit are found.
+      // The default limit of 2 is enough to check for a unique solution.  State is unchanged.
+      int CountSolutions(int limit=2){
+        emp_assert(limit >= 1, limit);
+        return RunSearch(limit, false);
+      }
+
        
       // More human-focused solving techniques:
+      //
+      // Each technique adds the moves it finds to the end of a MoveBuffer; the versions
+      // returning a std::vector are thin wrappers for convenience.
 
       // If there's only one state a cell can be, pick it!
-      std::vector<PuzzleMove> Solve_FindLastCellState(){
-        std::vector<PuzzleMove> moves;
+      // If dirty_only is set, only cells that changed since the last dirty scan are checked;
+      // cells that produce a move stay dirty so they are reported again until they are set.
+      void Solve_FindLastCellState(MoveBuffer & moves, bool dirty_only=false){
+        if (dirty_only) {
+          CellMask pending;
+          dirty_cells.ForEach([this, &moves, &pending](int i){
+              if (CountOptions(i) == 1) {
+                moves.AddSet(i, FindNext(i));
+                pending.Set(i);
+              }
+            });
+          dirty_cells = pending;
+          return;
+        }
 
         // For each cell, check if it has only one state left.
         for (int i = 0; i < NUM_CELLS; i++) {
           if (CountOptions(i) == 1) {
             // Find last value.
-            moves.emplace_back(PuzzleMove::SET_STATE, i, FindNext(i));
+            moves.AddSet(i, FindNext(i));
           }
         }
+      }
 
-        return moves;
+      std::vector<PuzzleMove> Solve_FindLastCellState(bool dirty_only=false){
+        MoveBuffer moves;
+        Solve_FindLastCellState(moves, dirty_only);
+        return moves.ToVector();
       }
 
       // If there's only one cell that can have a certain state in a region, choose it!
-      std::vector<PuzzleMove> Solve_FindLastRegionState(){
-        std::vector<PuzzleMove> moves;
-
-        // For each region, check if it has any states with only one available cell.
-        for (const auto & region : members) {
-          uint32_t opt_any = 0;     // Is a state an option in ANY cell?
-          uint32_t opt_multi = 0;   // Is a state an option in MULTIPLE cells?
-          for (const int c : region) {
-            opt_multi |= (options[c] & opt_any);  // If we already had an option AND see a new one.
-            opt_any |= options[c];                // Mark these options as possible.
-          }
-          const uint32_t opt_once = opt_any & ~opt_multi;
+      // If dirty_only is set, only regions that changed since the last dirty scan are checked;
+      // regions that produce moves stay dirty so they are reported again until resolved.
+      void Solve_FindLastRegionState(MoveBuffer & moves, bool dirty_only=false){
+        uint32_t todo = dirty_only ? dirty_regions : (1u << NUM_REGIONS) - 1;
+
+        // Determine which states have only one available cell in each region to check.
+        std::array<uint32_t, NUM_REGIONS> opt_once;
+        if (__builtin_popcount(todo) >= SIMD_MIN_REGIONS) {
+          simd::FindRegionOnce(options.data(), opt_once.data());
+        } else {
+          for (uint32_t t = todo; t; t &= t - 1) opt_once[__builtin_ctz(t)] = CalcRegionOnce(__builtin_ctz(t));
+        }
 
-          // If any options are only available in one cell, find them and lock them in.
-          if (opt_once) {
-            for (const int c : region) {
-              const uint32_t opt_unique = options[c] & opt_once;
-              if (opt_unique) {
-                moves.emplace_back(PuzzleMove::SET_STATE, c, next_opt[opt_unique]);
-              }
-            }
-          }
+        // If any options are only available in one cell, find them and lock them in.
+        uint32_t pending = 0;
+        for (; todo; todo &= todo - 1) {
+          const int region_id = __builtin_ctz(todo);
+          if (opt_once[region_id] == 0) continue;
+          AddLastRegionStates(region_id, opt_once[region_id], moves);
+          pending |= 1u << region_id;
         }
-        
-        return moves;
+        if (dirty_only) dirty_regions = pending;
+      }
+
+      std::vector<PuzzleMove> Solve_FindLastRegionState(bool dirty_only=false){
+        MoveBuffer moves;
+        Solve_FindLastRegionState(moves, dirty_only);
+        return moves.ToVector();
       }
 
       // If only cells that can have a state in region A are all also in region
       // B, no other cell in region B can have that state as a possibility.
-      std::vector<PuzzleMove> Solve_FindRegionOverlap(){
-        std::vector<PuzzleMove> moves;
+      void Solve_FindRegionOverlap(MoveBuffer & moves){
 
-        // Determine what options are available in each overlap region.
+        // Determine what options are available in each overlap region, and which options
+        // are available in only one of the three overlaps along each row/col, and along
+        // each box's rows or cols.
         std::array<uint32_t, NUM_OVERLAPS> overlap_options;
-        for (int i = 0; i < 54; i++) {
-          overlap_options[i] =
-            options[overlaps[i][0]] | options[overlaps[i][1]] | options[overlaps[i][2]];
-        }
+        std::array<uint32_t, NUM_OVERLAPS/3> line_once;
+        std::array<uint32_t, simd::NUM_BOX_GROUPS> box_once;
+        simd::FindOverlapOnce(options.data(), overlap_options.data(), line_once.data(), box_once.data());
 
         // If an option is available in only one overlap, then it must be there
         // (and cannot be elsewhere in the OTHER region that shares that overlap.)
+        // A cell can be reached from both its row and its col, so collect the blocks in
+        // per-state masks (as subsets and fish do) and emit each one once.
+        std::array<CellMask, NUM_STATES> blocks;
 
         // Start with row/col overlaps, which are in groups of three.
         for (int i = 0; i < NUM_OVERLAPS; i += 3) {
-          uint32_t single_opts =
-            (overlap_options[i] ^ overlap_options[i+1] ^ overlap_options[i+2]) &
-            ~(overlap_options[i] & overlap_options[i+1] & overlap_options[i+2]);
-
-          if (!single_opts) continue;
-
-          // If we made it this far, there is a move. Find the SQUARE region for this overlap.
-          const int square_id = overlap_regions[i][1];
-          for (int oid : square_overlaps[square_id]) {
-            if (oid == i) continue;
-            uint32_t extra_opts = single_opts & overlap_options[oid];
-
-            // We found options to block!  Lets step through all of the cells and options.
-            while (extra_opts) {
-              const int opt_id = next_opt[extra_opts];  // Determine this option.
-              extra_opts &= ~(1 << opt_id);             // Remove this option for future checks.
-              for (int cell_id : overlaps[oid]) {
-                if (HasOption(cell_id, opt_id)) {
-                  moves.emplace_back(PuzzleMove::BLOCK_STATE, cell_id, opt_id);
+          if (!line_once[i/3]) continue;
+
+          // Each confined option belongs to the square of the one overlap that holds it.
+          for (int line_oid = i; line_oid < i + 3; line_oid++) {
+            const uint32_t single_opts = line_once[i/3] & overlap_options[line_oid];
+            if (!single_opts) continue;
+
+            // If we made it this far, there is a move. Find the SQUARE region for this overlap.
+            const int square_id = overlap_regions[line_oid][1];
+            for (int oid : square_overlaps[square_id]) {
+              if (oid == line_oid) continue;
+              uint32_t extra_opts = single_opts & overlap_options[oid];
+
+              // We found options to block!  Lets step through all of the cells and options.
+              while (extra_opts) {
+                const int opt_id = next_opt[extra_opts];  // Determine this option.
+                extra_opts &= ~(1 << opt_id);             // Remove this option for future checks.
+                for (int cell_id : overlaps[oid]) {
+                  if (HasOption(cell_id, opt_id)) blocks[opt_id].Set(cell_id);
                 }
               }
             }
-            
           }
-        }    
-        return moves;
-      }
+        }
 
-      // If K cells are all limited to the same K states, eliminate those states
-      // from all other cells in the same region.
-      std::vector<PuzzleMove> Solve_FindLimitedCells(){  
-        std::vector<PuzzleMove> moves;
-        // Iterate through all regions (rows, columns, and boxes)
-        for (int region = 0; region < NUM_REGIONS; ++region) {
-          for(int pos = 0; pos < 9; ++pos){  // To loop over all the cells in each region
-            uint32_t first_option = GetOptions(members[region][pos]); 
-            int first_count_opts = CountOptions(members[region][pos]);
-            int count = first_count_opts; // to keep track of all the assigned positions
-            std::vector<int>matching_id;  // stores matching options
-            // Iterate through each cell in the region
-            for (const int cell_id : members[region]) {
-              uint32_t cell_options = GetOptions(cell_id);     
-              if ((cell_options == first_option) && count != 0){
-                  matching_id.push_back(cell_id);
-                  count -= 1;
-                  continue;
-              }
-            }
-              
-            if (count == 0){  // we have found all the available options, block the rest
-              for (const int cell_id : members[region]) {
-                uint32_t cell_options = GetOptions(cell_id);   
-                if(std::find(matching_id.begin(), matching_id.end(), cell_id) != matching_id.end()){  // check if the element is present in the vector
-                    continue;
-                }
-                else{
-                  options[cell_id] = ~first_option & cell_options;
+        // Then the boxes: an option confined to one row (or col) of a box cannot be
+        // elsewhere in that row (or col).
+        for (int g = 0; g < simd::NUM_BOX_GROUPS; g++) {
+          if (!box_once[g]) continue;
+
+          for (int k = 0; k < 3; k++) {
+            const int box_oid = simd::box_group_overlaps[k][g];
+            const uint32_t single_opts = box_once[g] & overlap_options[box_oid];
+            if (!single_opts) continue;
+
+            // The other two overlaps along the same row/col.
+            const int line_start = box_oid - box_oid % 3;
+            for (int oid = line_start; oid < line_start + 3; oid++) {
+              if (oid == box_oid) continue;
+              uint32_t extra_opts = single_opts & overlap_options[oid];
+              while (extra_opts) {
+                const int opt_id = next_opt[extra_opts];
+                extra_opts &= ~(1 << opt_id);
+                for (int cell_id : overlaps[oid]) {
+                  if (HasOption(cell_id, opt_id)) blocks[opt_id].Set(cell_id);
                 }
-              }     
+              }
             }
           }
         }
-        return moves;
+
+        AddBlockMoves(blocks, moves);
       }
-      
-      
-      // Eliminate all other possibilities from K cells if they are the only
-      // ones that can possess K states in a single region.    
-      std::vector<PuzzleMove> Solve_FindLimitedStates(){
-        std::vector<PuzzleMove> moves;
-        std::map<int, std::vector<int>> numberLocations;
-        for (int num = 1; num <= 9; ++num) {
-          for (int region = 0; region < NUM_REGIONS; ++region) {
-            for (const int cell_id : members[region]) {
-              uint32_t cell_options = GetOptions(cell_id);  // uint32_t type not same as int in my map
-              if ((1 << (num-1)) & cell_options ){
-              //if (cell_value == num) {
-                numberLocations[num].push_back(cell_id); // key = numbers(1-9), value = vector of locations
-              }
+
+      std::vector<PuzzleMove> Solve_FindRegionOverlap(){
+        MoveBuffer moves;
+        Solve_FindRegionOverlap(moves);
+        return moves.ToVector();
+      }
+
+      // Core of the subset and fish techniques.  items[i] is a 9-bit mask for each of nine
+      // items (the cells of a region, the states in a region, or the lines for a state).
+      // Find every combination of size items whose masks together cover exactly size bits;
+      // no other item can use those bits, so they are added to that item's clear mask.
+      // Only items with 1 to size bits can take part, and each branch of the search is
+      // pruned as soon as its cover exceeds size.  Nothing is allocated.
+      static void FindCovers(const uint32_t * items, int size, uint32_t * clear) {
+        std::array<int,9> item_ids;
+        int num_items = 0;
+        for (int i = 0; i < 9; i++) {                 // (Branch-free; these are unpredictable.)
+          const int count = opts_count[items[i]];
+          item_ids[num_items] = i;
+          num_items += (count > 0) & (count <= size);
+        }
+        if (num_items < size) return;
+
+        // Depth-first search over combinations, with the chosen items and their cover.
+        std::array<int,4> pos;
+        std::array<uint32_t,5> cover;
+        std::array<uint32_t,5> chosen;
+        cover[0] = chosen[0] = 0;
+        int depth = 0;
+        pos[0] = 0;
+        while (depth >= 0) {
+          if (pos[depth] > num_items - size + depth) { if (--depth >= 0) pos[depth]++; continue; }
+          const int item = item_ids[pos[depth]];
+          cover[depth+1] = cover[depth] | items[item];
+          chosen[depth+1] = chosen[depth] | (1u << item);
+          if (opts_count[cover[depth+1]] > size) { pos[depth]++; continue; }
+          if (depth + 1 < size) { depth++; pos[depth] = pos[depth-1] + 1; continue; }
+
+          // Found a covering set; every other item loses the covered bits.
+          for (int i = 0; i < 9; i++) {
+            if ((chosen[size] & (1u << i)) == 0) clear[i] |= items[i] & cover[size];
+          }
+          pos[depth]++;
+        }
+      }
+
+      // Turn a set of blocked options (per state) into BLOCK moves, ordered by state and cell.
+      static void AddBlockMoves(const std::array<CellMask, NUM_STATES> & blocks, MoveBuffer & moves) {
+        for (int state = 0; state < NUM_STATES; state++) {
+          blocks[state].ForEach([&moves, state](int cell){ moves.AddBlock(cell, state); });
+        }
+      }
+
+      // If K cells in a region are all limited to the same K states (a naked subset),
+      // eliminate those states from all other cells in the region.
+      void FindNakedSubsets(int size, std::array<CellMask, NUM_STATES> & blocks) const {
+        for (const auto & region : members) {
+          std::array<uint32_t,9> cell_opts;
+          std::array<uint32_t,9> clear{};
+          for (int pos = 0; pos < 9; pos++) cell_opts[pos] = options[region[pos]];
+          FindCovers(cell_opts.data(), size, clear.data());
+          for (int pos = 0; pos < 9; pos++) {
+            for (uint32_t opts = clear[pos]; opts; opts &= opts - 1) {
+              blocks[__builtin_ctz(opts)].Set(region[pos]);
             }
           }
         }
-        // check if vectors are equal
-        // if equal, eliminate those options from other cells
-        
-        // Create a map to store vectors of equal cells
-        std::map<std::vector<int>, std::vector<int>> equalVectorsMap; // the key is a vector that contains the equal cell_ids, the value is a vector of the associated numbers
-        std::unordered_set<std::vector<int>> visitedVectors;  // used so that we only process each vector once and avoid redundant iteration
-
-        // Find vectors that are equal in the numberLocations map
-        for (const auto& entry : numberLocations) {
-          const std::vector<int>& cell_ids = entry.second;
-          if (visitedVectors.find(cell_ids) == visitedVectors.end()) { // checks whether a vector "cell_ids" is already in the visitedVectors set
-            equalVectorsMap[cell_ids].push_back(entry.first); // do this if it is not in the set
-            visitedVectors.insert(cell_ids);  // used to avoid redundant iteration
+      }
+
+      // If K states can only go in the same K cells of a region (a hidden subset),
+      // eliminate all other states from those cells.
+      void FindHiddenSubsets(int size, std::array<CellMask, NUM_STATES> & blocks) const {
+        std::array<uint32_t, NUM_STATES*NUM_REGIONS> positions;
+        simd::FindStatePositions(options.data(), positions.data());
+
+        for (int region_id = 0; region_id < NUM_REGIONS; region_id++) {
+          std::array<uint32_t,9> state_pos;
+          std::array<uint32_t,9> clear{};
+          for (int state = 0; state < NUM_STATES; state++) {
+            state_pos[state] = positions[state*NUM_REGIONS + region_id];
           }
-          // fixe this ? 
-        }
-
-        // Block cells associated with equal vectors(containing cell_ids) from other numbers
-        for (const auto& entry : equalVectorsMap) {
-          const std::vector<int>& cell_ids = entry.first;
-          const std::vector<int>& associatedNumbers = entry.second;
-
-          for (int num : associatedNumbers) { 
-            for (int cell_id : cell_ids) { 
-              uint32_t cell_options = GetOptions(cell_id);  // get the options for that cell
-              for (int other_num = 1; other_num <= 9; ++other_num) {
-                if (std::find(associatedNumbers.begin(), associatedNumbers.end(), other_num) == associatedNumbers.end() ) { // check whether other_num is not present in the associatedNumbers vector(since it is equal to end, it is not found)
-                  /// algorithm remove is used to move the cell_ids to be eliminated from the vector at the end of the vector(without changing the order of the vector) and erase is used to delete them. 
-                  numberLocations[other_num].erase(std::remove(numberLocations[other_num].begin(), numberLocations[other_num].end(), cell_id), numberLocations[other_num].end());
-                  options[cell_id] = ~(1 << (other_num-1)) & cell_options;
-                }
-              }
+          FindCovers(state_pos.data(), size, clear.data());
+          for (int state = 0; state < NUM_STATES; state++) {
+            for (uint32_t cells = clear[state]; cells; cells &= cells - 1) {
+              blocks[state].Set(members[region_id][__builtin_ctz(cells)]);
             }
           }
         }
-        //options[cell_id] = ~first_option & cell_options;
-        //options[cell_id] = ~(1 << (other_num-1)) & cell_options;
+      }
+
+      void Solve_FindNakedSubsets(MoveBuffer & moves, int size){
+        emp_assert(size >= 2 && size <= 4, size);
+        std::array<CellMask, NUM_STATES> blocks;
+        FindNakedSubsets(size, blocks);
+        AddBlockMoves(blocks, moves);
+      }
+
+      void Solve_FindHiddenSubsets(MoveBuffer & moves, int size){
+        emp_assert(size >= 2 && size <= 4, size);
+        std::array<CellMask, NUM_STATES> blocks;
+        FindHiddenSubsets(size, blocks);
+        AddBlockMoves(blocks, moves);
+      }
+
+      std::vector<PuzzleMove> Solve_FindNakedSubsets(int size){
+        MoveBuffer moves;
+        Solve_FindNakedSubsets(moves, size);
+        return moves.ToVector();
+      }
+
+      std::vector<PuzzleMove> Solve_FindHiddenSubsets(int size){
+        MoveBuffer moves;
+        Solve_FindHiddenSubsets(moves, size);
+        return moves.ToVector();
+      }
+
+      // If K cells are all limited to the same K states, eliminate those states
+      // from all other cells in the same region.  (Naked pairs, triples, and quads.)
+      void Solve_FindLimitedCells(MoveBuffer & moves){
+        std::array<CellMask, NUM_STATES> blocks;
+        for (int size = 2; size <= 4; size++) FindNakedSubsets(size, blocks);
+        AddBlockMoves(blocks, moves);
+      }
 
-        return moves;
+      std::vector<PuzzleMove> Solve_FindLimitedCells(){  
+        MoveBuffer moves;
+        Solve_FindLimitedCells(moves);
+        return moves.ToVector();
+      }
+      
+      // Eliminate all other possibilities from K cells if they are the only
+      // ones that can possess K states in a single region.  (Hidden pairs, triples, and quads.)
+      void Solve_FindLimitedStates(MoveBuffer & moves){
+        std::array<CellMask, NUM_STATES> blocks;
+        for (int size = 2; size <= 4; size++) FindHiddenSubsets(size, blocks);
+        AddBlockMoves(blocks, moves);
+      }
 
-      }                    
+      std::vector<PuzzleMove> Solve_FindLimitedStates(){
+        MoveBuffer moves;
+        Solve_FindLimitedStates(moves);
+        return moves.ToVector();
+      }
 
       // If there are X rows (cols) where a certain state can only be in one of 
-      // X cols (rows), then no other row in this cols can be that state.     // do this
-      std::vector<PuzzleMove> Solve_FindSwordfish(){
-        std::vector<PuzzleMove> moves;
-        return moves;
+      // X cols (rows), then no other row in this cols can be that state.
+      // Find all fish with size base lines (2 = X-Wing, 3 = Swordfish, 4 = Jellyfish) along
+      // both rows and columns, for every state.
+      void Solve_FindFish(MoveBuffer & moves, int size){
+        emp_assert(size >= 2 && size <= 4, size);
+
+        // For each state, which columns of each row (and rows of each column) can hold it?
+        std::array<uint32_t, NUM_STATES*NUM_REGIONS> positions;
+        simd::FindStatePositions(options.data(), positions.data());
+
+        // Row and column fish may remove the same option; only report each once.
+        std::array<CellMask, NUM_STATES> blocks;
+        for (int state = 0; state < NUM_STATES; state++) {
+          std::array<uint32_t,9> row_clear{};
+          std::array<uint32_t,9> col_clear{};
+          FindCovers(&positions[state*NUM_REGIONS], size, row_clear.data());
+          FindCovers(&positions[state*NUM_REGIONS + 9], size, col_clear.data());
+          for (int line = 0; line < 9; line++) {
+            for (uint32_t cols = row_clear[line]; cols; cols &= cols - 1) {
+              blocks[state].Set(line*9 + __builtin_ctz(cols));
+            }
+            for (uint32_t rows = col_clear[line]; rows; rows &= rows - 1) {
+              blocks[state].Set(__builtin_ctz(rows)*9 + line);
+            }
+          }
+        }
+        AddBlockMoves(blocks, moves);
       }
 
+      std::vector<PuzzleMove> Solve_FindFish(int size){
+        MoveBuffer moves;
+        Solve_FindFish(moves, size);
+        return moves.ToVector();
+      }
+
+      std::vector<PuzzleMove> Solve_FindXWing() { return Solve_FindFish(2); }
+      std::vector<PuzzleMove> Solve_FindSwordfish() { return Solve_FindFish(3); }
+      std::vector<PuzzleMove> Solve_FindJellyfish() { return Solve_FindFish(4); }
+
       // Make sure the current state is consistent.
       bool OK(){    
         // Make sure we are associated with a puzzle.
@@ -722,19 +1136,40 @@ namespace pze {
     std::array<char, 9> symbols;      // What symbols are used in this puzzle?
     mutable SudokuState start_state;  // Starting state for puzzle (init when needed)
     mutable bool init;                // Has this puzzle been initialized yet?
+    uint64_t grid_id;                 // Hash of the full solution (cells).
+    bool complete;                    // Does cells hold a full solution grid (no -1 blanks)?
+    bool evaluated;                   // Are profile and fitness up to date?
+    double fitness;                   // Fitness from the last profile calculation.
+
+    // Shared cache of profiles for (start mask, grid) pairs; nullptr if not in use.
+    static inline ProfileCache * profile_cache = nullptr;
+
+    // Recalculate the grid id; must be called whenever cells change.
+    void UpdateGridID() {
+      uint64_t hash = 0xcbf29ce484222325ull;           // FNV-1a over the cell values.
+      for (int c : cells) {
+        hash ^= (uint64_t) (c + 1);
+        hash *= 0x100000001b3ull;
+      }
+      grid_id = hash;
+    }
     
-    // An iterative step to randomize the state of the grid.
-    // Return whether a valid solution was involved.
-    bool RandomizeCells_step(emp::Random & random, int next) {
-      if (next == 81) return true;  // If we pass the end, we found a solution!
-
-      // Test possible states for this cell in random order.
-      emp::vector<size_t> states( emp::GetPermutation(random, 9) );
+    // Note that this puzzle has changed; its start state and profile must be rebuilt.
+    void Invalidate() {
+      init = false;
+      evaluated = false;
+    }
 
-      // @CAO ACTUALLY DO TESTS HERE!!     
-      
-      // If all states have failed, return false (this is a dead-end)
-      return false;
+    // Fill any blank cells from a solution of the start cells; return false (leaving the
+    // blanks at -1) if there is none.
+    bool FillGrid() {
+      SudokuState state = GetState();
+      complete = state.ForceSolve();
+      if (complete) {
+        for (int i = 0; i < 81; i++) if (cells[i] == -1) cells[i] = state.GetValue(i);
+      }
+      UpdateGridID();
+      return complete;
     }
 
     void InitStartState() const {
@@ -761,22 +1196,43 @@ namespace pze {
                  2,3,8, 4,6,7, 5,0,1
               }})
       , symbols({{'1','2','3','4','5','6','7','8','9'}})
-      , start_state(this), init(false)
+      , start_state(this), init(false), complete(true), evaluated(false), fitness(0.0)
     {
       start_cells.fill(false);
+      UpdateGridID();
     }
     Sudoku(const Sudoku & in)
-      : cells(in.cells), start_cells(in.start_cells), symbols(in.symbols)
-      , start_state(this), init(false) { ; }
-    Sudoku(emp::Random & random, double start_prob=1.0) : start_state(this), init(false) {
+      : Puzzle(in), cells(in.cells), start_cells(in.start_cells), symbols(in.symbols)
+      , start_state(this), init(false), grid_id(in.grid_id), complete(in.complete)
+      , evaluated(in.evaluated), fitness(in.fitness) { ; }
+    Sudoku(emp::Random & random, double start_prob=1.0)
+      : symbols({{'1','2','3','4','5','6','7','8','9'}})
+      , start_state(this), init(false), grid_id(0), complete(true), evaluated(false), fitness(0.0)
+    {
       RandomizeCells(random);
       RandomizeStart(random, start_prob);
     }
-    Sudoku(std::istream & is) : start_state(this), init (false) { Load(is); }
-    Sudoku(const std::string & filename) : start_state(this), init(false) { Load(filename); }
+    Sudoku(std::istream & is) : start_state(this), init (false), grid_id(0), complete(false)
+      , evaluated(false), fitness(0.0) { Load(is); }
+    Sudoku(const std::string & filename) : start_state(this), init(false), grid_id(0)
+      , complete(false), evaluated(false), fitness(0.0) { Load(filename); }
     
     ~Sudoku() { ; }
 
+    // Copy the puzzle (and any calculated profile), but keep our own start state.
+    Sudoku & operator=(const Sudoku & in) {
+      Puzzle::operator=(in);
+      cells = in.cells;
+      start_cells = in.start_cells;
+      symbols = in.symbols;
+      init = false;
+      grid_id = in.grid_id;
+      complete = in.complete;
+      evaluated = in.evaluated;
+      fitness = in.fitness;
+      return *this;
+    }
+
     int GetCell(int id) const { return cells[id]; }
     bool GetStart(int id) const { return start_cells[id]; }
     char GetCellSymbol(int id) const { return start_cells[id] ? symbols[cells[id]] : '-'; }
@@ -784,29 +1240,100 @@ namespace pze {
     const std::array<int,81> & GetCells() const { return cells; }
     const std::array<bool,81> & GetStartCells() const { return start_cells; }
     const std::array<char,9> & GetSymbols() const { return symbols; }
+    uint64_t GetGridID() const { return grid_id; }
+    bool HasFullGrid() const { return complete; }
+    CellMask GetStartMask() const {
+      CellMask mask;
+      for (int i = 0; i < 81; i++) if (start_cells[i]) mask.Set(i);
+      return mask;
+    }
     const SudokuState & GetState() const {
       if (init == false) InitStartState();
       return start_state;
     }
 
+    // Replace the whole puzzle: solution cells (states 0-8), symbols, and start mask.
+    void SetPuzzle(const std::array<int,81> & in_cells, const std::array<char,9> & in_symbols,
+                   const CellMask & start) {
+      Invalidate();                 // If this puzzle was initialized or evaluated, it no longer is.
+      cells = in_cells;
+      symbols = in_symbols;
+      for (int i = 0; i < 81; i++) start_cells[i] = start.Has(i);
+      complete = true;
+      UpdateGridID();
+    }
+
+    // Set up a puzzle from its starting cells alone (states 0-8, or -1 for a blank), using
+    // the default symbols.  If solve is set, the blanks are filled in from a solution, as
+    // Load() does (return false if there is none).  Otherwise they are left at -1, which
+    // is all that CalcProfile() and CountSolutions() need; HasFullGrid() is then false,
+    // and Shuffle(), MutateStart(), canonicalization, and corpus records refuse the puzzle.
+    bool SetStartCells(const std::array<int,81> & start_values, bool solve=true) {
+      Invalidate();                 // If this puzzle was initialized or evaluated, it no longer is.
+      symbols = {{'1','2','3','4','5','6','7','8','9'}};
+      for (int i = 0; i < 81; i++) {
+        cells[i] = start_values[i];
+        start_cells[i] = (start_values[i] >= 0);
+      }
+
+      if (solve) return FillGrid();
+      complete = true;
+      for (int c : cells) if (c == -1) complete = false;
+      UpdateGridID();
+      return true;
+    }
+
     void SetStart(int id, bool new_start=true) {
-      init = false;                 // If this puzzle was initialized, it no longer is.
+      emp_assert(!new_start || cells[id] >= 0, "Only cells with a known value can be start cells.", id);
+      Invalidate();                 // If this puzzle was initialized or evaluated, it no longer is.
       start_cells[id] = new_start;
     }
+    // Toggling start cells needs the values of every cell, so without a full grid this
+    // does nothing.
     void MutateStart(emp::Random & random, double toggle_p=0.015) {
-      init = false;                 // If this puzzle was initialized, it no longer is.
+      emp_assert(complete, "MutateStart() requires a full solution grid.");
+      if (!complete) return;
       for (int i = 0; i < 81; i++) {
-        if (random.P(toggle_p)) start_cells[i] = !start_cells[i];
+        if (random.P(toggle_p)) {
+          start_cells[i] = !start_cells[i];
+          Invalidate();             // If this puzzle was initialized or evaluated, it no longer is.
+        }
       }
     }
 
+    // Count how many solutions the starting state has, stopping once limit are found.
+    int CountSolutions(int limit=2) const {
+      SudokuState state = GetState();
+      return state.CountSolutions(limit);
+    }
+    bool HasUniqueSolution() const { return CountSolutions(2) == 1; }
+
+    // Longer solving profiles score higher; puzzles the techniques cannot finish get a
+    // bonus, but only if they still have a unique solution.
+    static double CalcSimpleFitness(const PuzzleProfile & profile) {
+      if (profile.IsSolved()) return (double) profile.GetSize();
+      return (double) profile.GetSize() + (profile.IsUnique() ? 100 : 0);
+    }
+    // Fitness for matching a target solving experience: the closer the profile, the higher
+    // (at most zero).  Puzzles without a unique solution are heavily penalized.
+    static double CalcTargetFitness(const PuzzleProfile & profile, const PuzzleProfile & target) {
+      return (profile.IsUnique() ? 0.0 : -1000.0) - (double) profile.Distance(target);
+    }
+    // Fitness is only recalculated if the puzzle has changed since the last call.
     double CalcSimpleFitness() {
-      const auto & profile = CalcProfile();
-      return (double) profile.GetSize() + (profile.IsSolved() ? 0 : 100);
+      if (!evaluated) CalcProfile();
+      return fitness;
     }
+    bool IsEvaluated() const { return evaluated; }
+    double GetFitness() const { return fitness; }   // Only meaningful once evaluated.
+
+    // Share a profile cache among all puzzles (or pass nullptr to stop using one).
+    static void SetProfileCache(ProfileCache * cache) { profile_cache = cache; }
+    static ProfileCache * GetProfileCache() { return profile_cache; }
     
     bool Load(std::istream & is){
-      init = false;                 // If this puzzle was initialized, it no longer is.
+      Invalidate();                 // If this puzzle was initialized or evaluated, it no longer is.
+      complete = false;
 
       cells.fill(-1);               // Initialize all cells as unset.
       symbols.fill(0);              // Reset all symbols used.
@@ -849,14 +1376,8 @@ namespace pze {
       }
 
       // If any of the cells are still empty, fill them in by brute force
-      // (but don't mark them as starting cells!)
-      auto state = GetState();
-      state.ForceSolve();
-      for (int i = 0; i < 81; i++) {
-        if (cells[i] == -1) {
-          cells[i] = state.GetValue(i);
-        }
-      }
+      // (but don't mark them as starting cells!)  Without a solution they stay empty.
+      FillGrid();
       
       return true;
     }
@@ -866,26 +1387,23 @@ namespace pze {
       return Load(f);
     }
     
+    // Fill in a new random solution grid.  The three boxes on the diagonal share no rows or
+    // columns, so each is filled with an independent random permutation; the rest comes from
+    // the bitmask-propagating MRV search, trying states in random order at each branch.
     void RandomizeCells(emp::Random & random){
-      init = false;                 // If this puzzle was initialized, it no longer is.
-      // @CAO Do This!!!
-      // cells.fill(-1);                        // Clear out current cells
-      // solve.Clear();                         // Clear out helper info
-      // for (int i=0; i<9; i++) {              // Setup first cells to be 0-8
-      //   cells[i] = i;                        //   set cur cell id
-      //   solve.options[i].fill(false);        //   cross out most options
-      //   solve.options[i][i] = true;          //   ...except the one chosen.
-      //   for (int r : regions[i]) {           //   loop through all regions for this cell
-      //     for (int c : members[r]) {         //     loop through other cells in each region
-      //       if (i==c) continue;              //       ignore current cell
-      //       if (solve.options[c][i]) {       //       if new value was previously okay...
-      //         solve.opt_count[c]--;          //         note that one fewer option is available
-      //         solve.options[c][i] = false;   //         and mark off the option
-      //       }
-      //     }
-      //   }
-      // }
-      // RandomizeCells_step(random, 9);
+      Invalidate();                 // If this puzzle was initialized or evaluated, it no longer is.
+
+      SudokuState state(this);
+      for (int box = 0; box < 9; box += 4) {
+        emp::vector<size_t> perm = emp::GetPermutation(random, 9);
+        const int corner = (box / 3) * 27 + (box % 3) * 3;
+        for (int i = 0; i < 9; i++) state.Set(corner + (i / 3) * 9 + (i % 3), (int) perm[i]);
+      }
+      [[maybe_unused]] const bool solved = state.RandomSolve(random);
+      emp_assert(solved);
+      for (int i = 0; i < 81; i++) cells[i] = state.GetValue(i);
+      complete = true;
+      UpdateGridID();
     }
 
     // Shuffle will reorganize the board changing symbols and row/column order, but
@@ -893,8 +1411,11 @@ namespace pze {
     // * Remap all symbols
     // * Shuffle rows/columns within sets of three
     // * Shuffle rows/columns OF sets of three
+    // The puzzle must have a full solution grid; otherwise it is left unchanged.
     void Shuffle(emp::Random & random){
-      init = false;                 // If this puzzle was initialized, it no longer is.
+      emp_assert(complete, "Shuffle() requires a full solution grid.");
+      if (!complete) return;
+      Invalidate();                 // If this puzzle was initialized or evaluated, it no longer is.
       
       // Remap all states.
       emp::vector<size_t> remap = emp::GetPermutation(random,9);
@@ -948,20 +1469,22 @@ namespace pze {
           start_cells[R + c] = tmp_start[R + col_map[c]];
         }
       }
+      UpdateGridID();
     }
 
     void RandomizeStart(emp::Random & random, double start_prob=1.0){
       emp_assert(start_prob >= 0.0 && start_prob <= 1.0);
 
-      init = false;                 // If this puzzle was initialized, it no longer is.
+      Invalidate();                 // If this puzzle was initialized or evaluated, it no longer is.
       for (int i = 0; i < 81; i++) start_cells[i] = random.P(start_prob);
     }
 
-    // Print the current version of this puzzle; by default show start state only.
+    // Print the current version of this puzzle; by default show start state only.  Cells
+    // whose values are unknown (see HasFullGrid()) are always shown as blanks.
     void Print(bool full=false, std::ostream & out=std::cout) override{
       for (int id = 0; id < 81; id++) {
         if (id % 3 == 0) out << ' ';
-        if (full || start_cells[id]) {
+        if ((full || start_cells[id]) && cells[id] >= 0) {
           out << ' ' << symbols[ cells[id] ];
         } else {
           out << " -";
@@ -971,33 +1494,104 @@ namespace pze {
       }
     }
 
-    // Calculate the full solving profile based on the other techniques.
-    const PuzzleProfile & CalcProfile() override{
-      profile.Clear();  // Reset the profile if already calculated.
+    // Solving techniques, as rungs for a SolveLadder (see SolveLadder.h).  Singles only
+    // rescan the cells and regions changed by the previous moves.
+    struct LastCellTechnique {
+      static constexpr int LEVEL = LEVEL_LAST_CELL;
+      static constexpr const char * NAME = "LastCell";
+      static void Find(SudokuState & state, MoveBuffer & moves) { state.Solve_FindLastCellState(moves, true); }
+    };
 
-      // Setup a starting state for solving the puzzle.
-      SudokuState state = GetState();
+    struct LastRegionTechnique {
+      static constexpr int LEVEL = LEVEL_LAST_REGION;
+      static constexpr const char * NAME = "LastRegion";
+      static void Find(SudokuState & state, MoveBuffer & moves) { state.Solve_FindLastRegionState(moves, true); }
+    };
 
-      while (true) {    
-        auto moves = state.Solve_FindLastCellState();
-        if (moves.size() > 0) {
-          state.Move(moves);
-          profile.AddMoves(0, moves.size());
-          continue;
-        }
-        
-        moves = state.Solve_FindLastRegionState();
-        if (moves.size() > 0) {
-          state.Move(moves);
-          profile.AddMoves(1, moves.size());
-          continue;
-        }
-        
-        break;  // No new moves found!
+    template <int SIZE>
+    struct NakedSubsetTechnique {
+      static_assert(SIZE >= 2 && SIZE <= 4, "Subsets must have 2 to 4 cells.");
+      static constexpr int LEVEL = LEVEL_NAKED_PAIR + 2 * (SIZE - 2);
+      static constexpr const char * NAME = (SIZE == 2) ? "NakedPair" : (SIZE == 3) ? "NakedTriple" : "NakedQuad";
+      static void Find(SudokuState & state, MoveBuffer & moves) { state.Solve_FindNakedSubsets(moves, SIZE); }
+    };
+
+    template <int SIZE>
+    struct HiddenSubsetTechnique {
+      static_assert(SIZE >= 2 && SIZE <= 4, "Subsets must have 2 to 4 states.");
+      static constexpr int LEVEL = LEVEL_HIDDEN_PAIR + 2 * (SIZE - 2);
+      static constexpr const char * NAME = (SIZE == 2) ? "HiddenPair" : (SIZE == 3) ? "HiddenTriple" : "HiddenQuad";
+      static void Find(SudokuState & state, MoveBuffer & moves) { state.Solve_FindHiddenSubsets(moves, SIZE); }
+    };
+
+    template <int SIZE>
+    struct FishTechnique {
+      static_assert(SIZE >= 2 && SIZE <= 4, "Fish must have 2 to 4 base lines.");
+      static constexpr int LEVEL = LEVEL_XWING + (SIZE - 2);
+      static constexpr const char * NAME = (SIZE == 2) ? "XWing" : (SIZE == 3) ? "Swordfish" : "Jellyfish";
+      static void Find(SudokuState & state, MoveBuffer & moves) { state.Solve_FindFish(moves, SIZE); }
+    };
+
+    // Only singles; everything else is left to CountSolutions().
+    using SinglesLadder = SolveLadder<LastCellTechnique, LastRegionTechnique>;
+
+    // Every technique, easiest first; used by CalcProfile().
+    using DefaultLadder = SolveLadder<LastCellTechnique, LastRegionTechnique,
+                                      NakedSubsetTechnique<2>, HiddenSubsetTechnique<2>,
+                                      NakedSubsetTechnique<3>, HiddenSubsetTechnique<3>,
+                                      NakedSubsetTechnique<4>, HiddenSubsetTechnique<4>,
+                                      FishTechnique<2>, FishTechnique<3>, FishTechnique<4>>;
+
+    // Run a solving ladder from a state, adding each step to a profile, then record
+    // whether it solved the puzzle and (if not) whether it still has a unique solution.
+    // If stats is given, the ladder's per-technique counters are updated.
+    template <typename LADDER=DefaultLadder>
+    static void RunProfile(SudokuState & state, PuzzleProfile & profile,
+                           typename LADDER::Stats * stats=nullptr) {
+      // A contradiction means the starting cells allow no solution at all.
+      if (!LADDER::Run(state, profile, stats)) {
+        profile.SetSolved(false);
+        profile.SetSolutionCount(0);
+        return;
       }
 
       profile.SetSolved(state.IsSolved());
+
+      // The techniques only make forced moves, so if they finished, the solution is unique.
+      // Otherwise, count solutions from where they stalled (limit two; we only need to know
+      // if it is unique).
+      profile.SetSolutionCount(profile.IsSolved() ? 1 : state.CountSolutions(2));
       // state.OK();
+    }
+
+    // If a profile cache is in use, try to reuse a previous result for this start and grid.
+    bool LookupProfile() {
+      if (!profile_cache || !profile_cache->Lookup(GetStartMask(), grid_id, profile, fitness)) {
+        return false;
+      }
+      evaluated = true;
+      return true;
+    }
+
+    // Store a profile calculated elsewhere (such as by a SudokuBatch) as this puzzle's result.
+    void SetProfile(const PuzzleProfile & in_profile) {
+      if (&in_profile != &profile) profile = in_profile;
+      fitness = CalcSimpleFitness(profile);
+      evaluated = true;
+      if (profile_cache) profile_cache->Insert(GetStartMask(), grid_id, profile, fitness);
+    }
+
+    // Calculate the full solving profile based on the other techniques.
+    // The profile (and fitness) are stored, and only recalculated after the puzzle changes.
+    const PuzzleProfile & CalcProfile() override{
+      if (evaluated) return profile;
+      profile.Clear();  // Reset the profile if already calculated.
+      if (LookupProfile()) return profile;
+
+      // Setup a starting state for solving the puzzle.
+      SudokuState state = GetState();
+      RunProfile(state, profile);
+      SetProfile(profile);
       
       return profile;
       };
@@ -0,0 +1,319 @@
+//  This file is part of PuzzleEngine, https://github.com/mercere99/PuzzleEngine/
+//  Copyright (C) Michigan State University, 2015.
+//  Released under the MIT Software license; see doc/LICENSE
+//
+//
+//  SudokuBatch evaluates up to NUM_LANES puzzles in lockstep.
+//
+//  Options are stored structure-of-arrays: for each cell, one 16-bit option word per
+//  puzzle ("lane"), so every step of the singles ladder from Sudoku::CalcProfile() is a
+//  run of plain loops over lanes that the compiler turns into vector instructions.  At
+//  each step a lane makes all of its naked-single moves if it has any, and otherwise all
+//  of its hidden-single moves, exactly as the scalar ladder does; lanes that find neither
+//  are marked done.  Lanes that stall before the puzzle is solved are finished on a
+//  scalar SudokuState with Sudoku::RunProfile(), so profiles always match CalcProfile().
+//
+//  After the starting cells and after every step, each lane is checked for the same
+//  contradictions SudokuState flags: a cell set to a state it had lost (or to two states
+//  at once), or an unset cell with no options left.  A contradictory lane stops there and
+//  is recorded as unsolved with no solutions, as RunProfile() records it.
+
+#ifndef PZE_SUDOKU_BATCH_H
+#define PZE_SUDOKU_BATCH_H
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include "base/assert.hpp"
+#include "Puzzle.h"
+#include "Sudoku.h"
+#include "SudokuPlanes.h"
+#include "ThreadPool.h"
+
+#if defined(__x86_64__) && !defined(__EMSCRIPTEN__)
+#define PZE_BATCH_TARGET __attribute__((target_clones("avx2","default")))
+#else
+#define PZE_BATCH_TARGET
+#endif
+
+namespace pze {
+
+  namespace internal {
+    // Cell ids in each region, and the 20 peers of each cell.
+    struct BatchTables {
+      std::array<std::array<uint8_t,9>,27> members;
+      std::array<std::array<uint8_t,20>,81> peers;
+    };
+
+    constexpr BatchTables BuildBatchTables() {
+      BatchTables tables{};
+      std::array<int,27> member_count{};
+      for (int cell = 0; cell < 81; cell++) {
+        for (int region : { RowOf(cell), ColOf(cell), BoxOf(cell) }) {
+          tables.members[region][member_count[region]++] = (uint8_t) cell;
+        }
+        int peer_count = 0;
+        for (int other = 0; other < 81; other++) {
+          if (other == cell) continue;
+          if (RowOf(other) == RowOf(cell) || ColOf(other) == ColOf(cell) || BoxOf(other) == BoxOf(cell)) {
+            tables.peers[cell][peer_count++] = (uint8_t) other;
+          }
+        }
+      }
+      return tables;
+    }
+  }
+
+  class SudokuBatch {
+  public:
+    static constexpr int NUM_LANES = 16;
+
+  private:
+    static constexpr int NUM_CELLS = 81;
+    static constexpr int NUM_REGIONS = 27;
+    static constexpr internal::BatchTables tables = internal::BuildBatchTables();
+
+    // One 16-bit word per lane; GCC/Clang vector extensions map operations on these onto
+    // SIMD registers where available (and plain loops elsewhere).
+    using lanes_t = uint16_t __attribute__((vector_size(2 * NUM_LANES)));
+
+    std::array<lanes_t, NUM_CELLS> options;       // Options left in each cell, per lane.
+    std::array<lanes_t, NUM_CELLS> values;        // Bit of the state set in each cell (0 = unset).
+    std::array<lanes_t, NUM_CELLS> cell_sets;     // Naked-single moves found this step.
+    std::array<lanes_t, NUM_CELLS> region_sets;   // Hidden-single moves found this step.
+    lanes_t cell_count;                           // Naked-single moves this step, per lane.
+    lanes_t region_count;                         // Hidden-single moves this step, per lane.
+    uint32_t contradictions;                      // Lanes that have reached a contradiction.
+    std::array<Sudoku*, NUM_LANES> puzzles;
+    std::array<PuzzleProfile, NUM_LANES> profiles;
+    int num_lanes;
+
+    // Is any bit set in any lane?
+    static bool AnyBits(const lanes_t & x) {
+      uint64_t words[sizeof(lanes_t) / 8];
+      std::memcpy(words, &x, sizeof(lanes_t));
+      uint64_t any = 0;
+      for (uint64_t w : words) any |= w;
+      return any != 0;
+    }
+
+    // Find the moves for one step of the ladder in every lane; return the lanes with no moves.
+    // (Comparisons on vectors give all-ones in each true lane, so subtracting one counts it.)
+    uint32_t FindMoves() {
+      const lanes_t zero = {};
+      cell_count = zero;
+      region_count = zero;
+
+      // Naked singles: cells with exactly one option left.
+      for (int c = 0; c < NUM_CELLS; c++) {
+        const lanes_t opts = options[c];
+        const lanes_t single = (lanes_t) ((opts != 0) & ((opts & (opts - 1)) == 0));
+        cell_sets[c] = opts & single;
+        cell_count -= single;
+        region_sets[c] = zero;
+      }
+
+      // Hidden singles: states available in only one cell of a region.  (The same move can
+      // be found through several regions; like the scalar ladder, each one is counted.  A
+      // cell holding two such states of one region, possible only in a contradictory
+      // state, takes the lower one, as the scalar ladder does.)
+      for (const auto & region : tables.members) {
+        lanes_t opt_any = zero, opt_multi = zero;
+        for (const int c : region) {
+          opt_multi |= options[c] & opt_any;
+          opt_any |= options[c];
+        }
+        const lanes_t opt_once = opt_any & ~opt_multi;
+        if (!AnyBits(opt_once)) continue;
+        for (const int c : region) {
+          lanes_t opt_unique = options[c] & opt_once;
+          opt_unique &= zero - opt_unique;                // Lowest state only.
+          region_sets[c] |= opt_unique;
+          region_count -= (lanes_t) (opt_unique != 0);
+        }
+      }
+
+      uint32_t stalled = 0;
+      for (int l = 0; l < NUM_LANES; l++) {
+        if (cell_count[l] == 0 && region_count[l] == 0) stalled |= 1u << l;
+      }
+      return stalled;
+    }
+
+    // Lock in the moves found for each lane (naked singles if it has any, otherwise hidden
+    // singles), removing each newly set state from the cell's peers.  Lanes that reach a
+    // contradiction are added to contradictions and have their options cleared, so they
+    // find no further moves.
+    void ApplyMoves() {
+      const lanes_t zero = {};
+      const lanes_t use_cells = (lanes_t) (cell_count != 0);
+      lanes_t bad = zero;                 // Nonzero in lanes that set a state they lacked.
+      for (int c = 0; c < NUM_CELLS; c++) {
+        const lanes_t bits = (cell_sets[c] & use_cells) | (region_sets[c] & ~use_cells);
+        if (!AnyBits(bits)) continue;     // Nothing set in this cell in any lane.
+
+        bad |= (bits & ~options[c]) | (bits & (bits - 1));
+        values[c] |= bits;
+        options[c] &= (lanes_t) (bits == 0);
+        for (const int p : tables.peers[c]) options[p] &= ~bits;
+      }
+
+      // Unset cells with no options left.
+      for (int c = 0; c < NUM_CELLS; c++) bad |= (lanes_t) ((options[c] | values[c]) == 0);
+      if (!AnyBits(bad)) return;
+
+      uint32_t found = 0;
+      for (int l = 0; l < num_lanes; l++) if (bad[l]) found |= 1u << l;
+      found &= ~contradictions;
+      if (found == 0) return;
+      contradictions |= found;
+      const lanes_t keep = (lanes_t) (bad == 0);
+      for (int c = 0; c < NUM_CELLS; c++) options[c] &= keep;
+    }
+
+    // Run the singles ladder in all lanes until every lane has stalled.  On x86 this is also
+    // compiled for AVX2 (selected at load time), where a whole lane set fits one register.
+    PZE_BATCH_TARGET
+    void RunSingles() {
+      // Unused lanes start with no options and finish immediately.
+      for (int c = 0; c < NUM_CELLS; c++) {
+        for (int l = num_lanes; l < NUM_LANES; l++) options[c][l] = cell_sets[c][l] = 0;
+      }
+
+      // Set the starting cells in every lane.
+      contradictions = 0;
+      cell_count = ~(lanes_t){};
+      ApplyMoves();
+
+      const uint32_t all_lanes = (1u << NUM_LANES) - 1;
+      uint32_t done = 0;
+      while (done != all_lanes) {
+        const uint32_t stalled = FindMoves();
+        [[maybe_unused]] const uint32_t progressed = ~(done | stalled);   // (For stats.)
+        done |= stalled;
+        for (int l = 0; l < num_lanes; l++) {
+          if (cell_count[l]) profiles[l].AddMoves(Sudoku::LEVEL_LAST_CELL, cell_count[l]);
+          else if (region_count[l]) profiles[l].AddMoves(Sudoku::LEVEL_LAST_REGION, region_count[l]);
+#ifdef PZE_STATS
+          // Count as the scalar ladder would; a lane's final, stalled step is counted by the
+          // scalar ladder that finishes it (or not at all, if it is solved).
+          if ((progressed >> l) & 1) {
+            PZE_STAT(technique_calls[Sudoku::LEVEL_LAST_CELL]++);
+            PZE_STAT(technique_hits[Sudoku::LEVEL_LAST_CELL] += (cell_count[l] != 0));
+            if (cell_count[l] == 0) {
+              PZE_STAT(technique_calls[Sudoku::LEVEL_LAST_REGION]++);
+              PZE_STAT(technique_hits[Sudoku::LEVEL_LAST_REGION] += (region_count[l] != 0));
+            }
+          }
+#endif
+        }
+        ApplyMoves();
+      }
+    }
+
+    bool IsLaneSolved(int lane) const {
+      for (int c = 0; c < NUM_CELLS; c++) if (options[c][lane]) return false;
+      return true;
+    }
+
+  public:
+    SudokuBatch() : contradictions(0), num_lanes(0) { ; }
+    SudokuBatch(const SudokuBatch &) = delete;
+    ~SudokuBatch() { ; }
+    SudokuBatch & operator=(const SudokuBatch &) = delete;
+
+    int GetSize() const { return num_lanes; }
+    bool IsFull() const { return num_lanes == NUM_LANES; }
+    void Clear() { num_lanes = 0; }
+
+    // Load the starting cells of a puzzle into the next free lane.  Their states are removed
+    // from the other cells' options at the start of Run(), across all lanes at once.
+    void Add(Sudoku & puz) {
+      emp_assert(num_lanes < NUM_LANES, num_lanes);
+      for (int c = 0; c < NUM_CELLS; c++) {
+        options[c][num_lanes] = 511;
+        cell_sets[c][num_lanes] = puz.GetStart(c) ? (uint16_t) (1 << puz.GetCell(c)) : 0;
+        values[c][num_lanes] = 0;
+      }
+      puzzles[num_lanes] = &puz;
+      profiles[num_lanes].Clear();
+      num_lanes++;
+    }
+
+    // Calculate the profile of every loaded puzzle and store it in the puzzle; then clear.
+    void Run() {
+      RunSingles();
+
+      for (int l = 0; l < num_lanes; l++) {
+        if ((contradictions >> l) & 1) {
+          profiles[l].SetSolved(false);
+          profiles[l].SetSolutionCount(0);
+        } else if (IsLaneSolved(l)) {
+          profiles[l].SetSolved(true);
+          profiles[l].SetSolutionCount(1);
+        } else {
+          // Rebuild the stalled lane as a scalar state and let the full ladder finish it.
+          Sudoku::SudokuState state(puzzles[l]);
+          for (int c = 0; c < NUM_CELLS; c++) {
+            if (values[c][l]) state.Set(c, __builtin_ctz(values[c][l]));
+          }
+          Sudoku::RunProfile(state, profiles[l]);
+        }
+        puzzles[l]->SetProfile(profiles[l]);
+      }
+      Clear();
+    }
+
+    // Evaluate a list of puzzles, NUM_LANES at a time.  Puzzles that are already evaluated
+    // (or found in the profile cache) are skipped.
+    void Evaluate(Sudoku * const * puz_list, size_t count) {
+      for (size_t i = 0; i < count; i++) {
+        Sudoku & puz = *puz_list[i];
+        if (puz.IsEvaluated() || puz.LookupProfile()) continue;
+        Add(puz);
+        if (IsFull()) Run();
+      }
+      if (num_lanes) Run();
+    }
+  };
+
+  // Gather the puzzles in a population that need evaluating, so that batches are filled as
+  // fully as possible.
+  template <typename POP_T>
+  std::vector<Sudoku*> FindUnevaluated(POP_T & pop) {
+    std::vector<Sudoku*> todo;
+    for (int i = 0; i < pop.GetSize(); i++) {
+      if (!pop[i].IsEvaluated()) todo.push_back(&pop[i]);
+    }
+    return todo;
+  }
+
+  // Evaluate every puzzle in a population in batches, on the calling thread (e.g., from
+  // inside a task that is already running on a pool).
+  template <typename POP_T>
+  void EvaluatePopulationBatched(POP_T & pop) {
+    std::vector<Sudoku*> todo = FindUnevaluated(pop);
+    SudokuBatch batch;
+    batch.Evaluate(todo.data(), todo.size());
+  }
+
+  // Evaluate every puzzle in a population using batches spread across a thread pool.
+  // Works with any population type offering GetSize() and operator[].
+  template <typename POP_T>
+  void EvaluatePopulationBatched(POP_T & pop, ThreadPool & pool) {
+    std::vector<Sudoku*> todo = FindUnevaluated(pop);
+
+    const size_t group_size = 4 * SudokuBatch::NUM_LANES;
+    const size_t num_groups = (todo.size() + group_size - 1) / group_size;
+    pool.ParallelFor(num_groups, [&todo, group_size](size_t group){
+        SudokuBatch batch;
+        const size_t start = group * group_size;
+        batch.Evaluate(todo.data() + start, std::min(group_size, todo.size() - start));
+      }, 4);
+  }
+
+}
+
+#endif
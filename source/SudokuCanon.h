@@ -0,0 +1,266 @@
+//  This file is part of PuzzleEngine, https://github.com/mercere99/PuzzleEngine/
+//  Copyright (C) Michigan State University, 2015.
+//  Released under the MIT Software license; see doc/LICENSE
+//
+//
+//  Canonical (minimal lexicographic) forms of sudoku puzzles, for spotting duplicates.
+//
+//  Two puzzles are equivalent if one can be turned into the other by the moves that
+//  Sudoku::Shuffle() uses (relabeling symbols, permuting rows within bands and columns
+//  within stacks, permuting bands and stacks) plus transposition.  A puzzle here is a
+//  solution grid together with its start mask.
+//
+//  Each cell gets a key of (symbol * 2 + (start ? 0 : 1)), with symbols relabeled in order
+//  of first appearance, and the canonical form is the equivalent puzzle whose keys, read
+//  row by row, are smallest.  Rows are packed into one integer each (five bits per cell,
+//  first cell highest), so comparing rows is a single integer comparison.
+//
+//  The search tries each transposition, first row, and column arrangement; the first row
+//  fixes the relabeling, after which the best order for the remaining rows follows
+//  directly (rows of a grid are all distinct).  Column arrangements are pruned a stack at
+//  a time on the first row, and candidates are dropped at the first row where they lose.
+
+#ifndef PZE_SUDOKU_CANON_H
+#define PZE_SUDOKU_CANON_H
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "base/assert.hpp"
+#include "CellMask.h"
+#include "Sudoku.h"
+
+namespace pze {
+
+  class CanonicalForm {
+  private:
+    static constexpr uint64_t KEY_MASK = 31;
+
+    std::array<uint64_t, 9> rows;   // Packed cell keys for each row.
+
+    uint64_t GetKey(int cell) const { return (rows[cell/9] >> (5 * (8 - cell%9))) & KEY_MASK; }
+
+  public:
+    CanonicalForm() { rows.fill(0); }
+    CanonicalForm(const std::array<uint64_t, 9> & in_rows) : rows(in_rows) { ; }
+    CanonicalForm(const CanonicalForm &) = default;
+    CanonicalForm & operator=(const CanonicalForm &) = default;
+
+    int GetCell(int cell) const { return (int) (GetKey(cell) >> 1); }
+    bool GetStart(int cell) const { return (GetKey(cell) & 1) == 0; }
+    uint64_t GetRow(int row) const { return rows[row]; }
+    bool IsEmpty() const { return rows == std::array<uint64_t, 9>{}; }
+
+    uint64_t GetHash() const {
+      uint64_t hash = 0x9e3779b97f4a7c15ull;
+      for (uint64_t row : rows) {
+        hash = (hash ^ row) * 0xff51afd7ed558ccdull;
+        hash ^= hash >> 32;
+      }
+      return hash;
+    }
+
+    bool operator==(const CanonicalForm & in) const { return rows == in.rows; }
+    bool operator!=(const CanonicalForm & in) const { return rows != in.rows; }
+    bool operator<(const CanonicalForm & in) const { return rows < in.rows; }
+  };
+
+  class SudokuCanonicalizer {
+  private:
+    static constexpr uint64_t ROW_MAX = (1ull << 45) - 1;   // Larger than any real row.
+    static constexpr int perms3[6][3] = { {0,1,2}, {0,2,1}, {1,0,2}, {1,2,0}, {2,0,1}, {2,1,0} };
+
+    std::array<uint8_t, 81> grid;    // Symbols of the puzzle (transposed, if being tried).
+    std::array<uint8_t, 81> open;    // 0 for start cells, 1 for the rest.
+    std::array<uint64_t, 9> best;    // Best rows found so far.
+    std::array<int, 9> col;          // Column arrangement being tried.
+
+    // Key of a row (under the current column arrangement and relabeling).
+    uint64_t RowKey(int row, const std::array<uint8_t, 9> & relabel) const {
+      uint64_t key = 0;
+      for (int i = 0; i < 9; i++) {
+        const int cell = row * 9 + col[i];
+        key = (key << 5) | (uint64_t) (relabel[grid[cell]] * 2 + open[cell]);
+      }
+      return key;
+    }
+
+    // Sort three row keys.
+    static void Sort3(uint64_t & a, uint64_t & b, uint64_t & c) {
+      if (b < a) std::swap(a, b);
+      if (c < b) std::swap(b, c);
+      if (b < a) std::swap(a, b);
+    }
+
+    // Compare the next candidate row against the best; return false if the candidate lost.
+    static bool Check(uint64_t row, uint64_t best_row, bool & better) {
+      if (better) return true;
+      if (row > best_row) return false;
+      better = (row < best_row);
+      return true;
+    }
+
+    // Finish a candidate with the first row r0 (whose key is row0) in the current arrangement.
+    void TryCandidate(int r0, uint64_t row0) {
+      bool better = false;
+      if (!Check(row0, best[0], better)) return;
+
+      std::array<uint8_t, 9> relabel;
+      for (int i = 0; i < 9; i++) relabel[grid[r0 * 9 + col[i]]] = (uint8_t) i;
+
+      // The rest of the first band, smaller row first.
+      const int band0 = r0 / 3;
+      const int ra = band0 * 3 + (r0 % 3 == 0 ? 1 : 0);
+      const int rb = band0 * 3 + (r0 % 3 == 2 ? 1 : 2);
+      uint64_t row1 = RowKey(ra, relabel);
+      uint64_t row2 = RowKey(rb, relabel);
+      if (row2 < row1) std::swap(row1, row2);
+      if (!Check(row1, best[1], better)) return;
+      if (!Check(row2, best[2], better)) return;
+
+      // The other two bands: each sorted, then ordered by their smallest rows.
+      const int band1 = (band0 == 0) ? 1 : 0;
+      const int band2 = (band0 == 2) ? 1 : 2;
+      std::array<uint64_t, 6> rest;
+      for (int i = 0; i < 3; i++) {
+        rest[i] = RowKey(band1 * 3 + i, relabel);
+        rest[i + 3] = RowKey(band2 * 3 + i, relabel);
+      }
+      Sort3(rest[0], rest[1], rest[2]);
+      Sort3(rest[3], rest[4], rest[5]);
+      if (rest[3] < rest[0]) {
+        std::swap(rest[0], rest[3]);
+        std::swap(rest[1], rest[4]);
+        std::swap(rest[2], rest[5]);
+      }
+      for (int i = 0; i < 6; i++) {
+        if (!Check(rest[i], best[i + 3], better)) return;
+      }
+
+      if (better) best = { row0, row1, row2, rest[0], rest[1], rest[2], rest[3], rest[4], rest[5] };
+    }
+
+    // Try every first row and column arrangement for the current grid.
+    void SearchGrid() {
+      for (int r0 = 0; r0 < 9; r0++) {
+        const uint8_t * first_open = &open[r0 * 9];
+        for (const auto & stacks : perms3) {
+          for (const auto & p0 : perms3) {
+            // The first row's keys are (position * 2 + open); only the open bits vary.
+            uint64_t key0 = 0;
+            for (int j = 0; j < 3; j++) {
+              col[j] = stacks[0] * 3 + p0[j];
+              key0 = (key0 << 5) | (uint64_t) (j * 2 + first_open[col[j]]);
+            }
+            if (key0 > (best[0] >> 30)) continue;
+            for (const auto & p1 : perms3) {
+              uint64_t key1 = key0;
+              for (int j = 0; j < 3; j++) {
+                col[3 + j] = stacks[1] * 3 + p1[j];
+                key1 = (key1 << 5) | (uint64_t) ((3 + j) * 2 + first_open[col[3 + j]]);
+              }
+              if (key1 > (best[0] >> 15)) continue;
+              for (const auto & p2 : perms3) {
+                uint64_t key2 = key1;
+                for (int j = 0; j < 3; j++) {
+                  col[6 + j] = stacks[2] * 3 + p2[j];
+                  key2 = (key2 << 5) | (uint64_t) ((6 + j) * 2 + first_open[col[6 + j]]);
+                }
+                TryCandidate(r0, key2);
+              }
+            }
+          }
+        }
+      }
+    }
+
+  public:
+    SudokuCanonicalizer() { ; }
+
+    // Find the canonical form of a solution grid (symbols 0-8) with a start mask.
+    CanonicalForm Canonicalize(const std::array<int, 81> & cells, const CellMask & start) {
+      best.fill(ROW_MAX);
+      for (int transpose = 0; transpose < 2; transpose++) {
+        for (int r = 0; r < 9; r++) {
+          for (int c = 0; c < 9; c++) {
+            const int from = transpose ? (c * 9 + r) : (r * 9 + c);
+            grid[r * 9 + c] = (uint8_t) cells[from];
+            open[r * 9 + c] = start.Has(from) ? 0 : 1;
+          }
+        }
+        SearchGrid();
+      }
+      return CanonicalForm(best);
+    }
+
+    // A puzzle without a full solution grid (see Sudoku::HasFullGrid()) has no canonical
+    // form; it is refused with an empty form, which no real puzzle can have.
+    CanonicalForm Canonicalize(const Sudoku & puz) {
+      emp_assert(puz.HasFullGrid(), "Only puzzles with a full solution grid can be canonicalized.");
+      if (!puz.HasFullGrid()) return CanonicalForm();
+      std::array<int, 81> cells;
+      for (int i = 0; i < 81; i++) cells[i] = puz.GetCell(i);
+      return Canonicalize(cells, puz.GetStartMask());
+    }
+  };
+
+  // Shortcut for a one-off canonical hash of a puzzle.
+  inline uint64_t CalcCanonicalHash(const Sudoku & puz) {
+    SudokuCanonicalizer canon;
+    return canon.Canonicalize(puz).GetHash();
+  }
+
+  // A compact set of 64-bit canonical hashes (open addressing, linear probing), for
+  // noticing puzzles that are equivalent to ones already seen.
+  class CanonicalHashSet {
+  private:
+    std::vector<uint64_t> slots;   // Zero marks an empty slot.
+    size_t num_hashes;
+
+    // Zero is reserved for empty slots.
+    static uint64_t Fix(uint64_t hash) { return hash ? hash : 1; }
+
+    size_t FindSlot(uint64_t hash) const {
+      const size_t mask = slots.size() - 1;
+      size_t pos = (size_t) (hash ^ (hash >> 29)) & mask;
+      while (slots[pos] != 0 && slots[pos] != hash) pos = (pos + 1) & mask;
+      return pos;
+    }
+
+    void Grow() {
+      std::vector<uint64_t> old_slots(slots.size() * 2, 0);
+      std::swap(slots, old_slots);
+      for (uint64_t hash : old_slots) if (hash) slots[FindSlot(hash)] = hash;
+    }
+
+  public:
+    CanonicalHashSet(size_t min_slots=1024) : num_hashes(0) {
+      size_t size = 16;
+      while (size < min_slots) size <<= 1;
+      slots.assign(size, 0);
+    }
+
+    size_t GetSize() const { return num_hashes; }
+    void Clear() { std::fill(slots.begin(), slots.end(), 0); num_hashes = 0; }
+
+    bool Has(uint64_t hash) const { return slots[FindSlot(Fix(hash))] != 0; }
+
+    // Add a hash; return true if it was new.
+    bool Insert(uint64_t hash) {
+      hash = Fix(hash);
+      size_t pos = FindSlot(hash);
+      if (slots[pos] == hash) return false;
+      if (2 * (num_hashes + 1) > slots.size()) {   // Keep the table at most half full.
+        Grow();
+        pos = FindSlot(hash);
+      }
+      slots[pos] = hash;
+      num_hashes++;
+      return true;
+    }
+  };
+
+}
+
+#endif
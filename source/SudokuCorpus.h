@@ -0,0 +1,274 @@
+//  This file is part of PuzzleEngine, https://github.com/mercere99/PuzzleEngine/
+//  Copyright (C) Michigan State University, 2015.
+//  Released under the MIT Software license; see doc/LICENSE
+//
+//
+//  A binary corpus of sudoku puzzles with fixed-size records.
+//
+//  A corpus file is a 16-byte header (magic "PZECORP", version, record size) followed by
+//  one RECORD_SIZE-byte record per puzzle:
+//
+//    offset  size  contents
+//         0    16  start mask (CellMask low word, then high word; little endian)
+//        16    41  solution cells, 4 bits each (even cells in the low nibble)
+//        57     9  symbols
+//        66     1  flags: bit 0 = has profile summary, bit 1 = solved
+//        67     1  solution count (signed; -1 = unknown, capped at 127)
+//        68     2  number of profile steps
+//        70     2  total moves over all steps (capped at 65535)
+//        72     4  fitness (float)
+//        76     1  hardest level used
+//        77     3  (reserved, zero)
+//
+//  CorpusWriter appends records to a file.  CorpusReader maps a whole file into memory
+//  (or reads it, where mmap is not available) and hands out SudokuViews, which read the
+//  fields straight out of the record without copying or building a Sudoku.
+
+#ifndef PZE_SUDOKU_CORPUS_H
+#define PZE_SUDOKU_CORPUS_H
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "base/assert.hpp"
+#include "CellMask.h"
+#include "Sudoku.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#define PZE_CORPUS_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace pze {
+
+  namespace corpus {
+    static constexpr char MAGIC[8] = { 'P','Z','E','C','O','R','P','\0' };
+    static constexpr uint32_t VERSION = 1;
+    static constexpr size_t HEADER_SIZE = 16;
+    static constexpr size_t RECORD_SIZE = 80;
+
+    // Field offsets within a record.
+    enum RecordField {
+      MASK_POS = 0, CELLS_POS = 16, SYMBOLS_POS = 57, FLAGS_POS = 66, SOLUTIONS_POS = 67,
+      STEPS_POS = 68, MOVES_POS = 70, FITNESS_POS = 72, MAX_LEVEL_POS = 76
+    };
+
+    enum RecordFlags { HAS_PROFILE = 1, SOLVED = 2 };
+
+    template <typename T> T ReadField(const uint8_t * record, int pos) {
+      T value;
+      std::memcpy(&value, record + pos, sizeof(T));
+      return value;
+    }
+    template <typename T> void WriteField(uint8_t * record, int pos, T value) {
+      std::memcpy(record + pos, &value, sizeof(T));
+    }
+
+    // Fill in a record for a puzzle (including its profile summary, if it is evaluated).
+    // Records hold the full solution grid, so return false for a puzzle without one.
+    inline bool EncodeRecord(const Sudoku & puz, uint8_t * record) {
+      std::memset(record, 0, RECORD_SIZE);
+      if (!puz.HasFullGrid()) return false;
+      const CellMask mask = puz.GetStartMask();
+      WriteField<uint64_t>(record, MASK_POS, mask.GetLo());
+      WriteField<uint64_t>(record, MASK_POS + 8, mask.GetHi());
+      for (int i = 0; i < 81; i++) {
+        record[CELLS_POS + i/2] |= (uint8_t) (puz.GetCell(i) << (4 * (i & 1)));
+      }
+      std::memcpy(record + SYMBOLS_POS, puz.GetSymbols().data(), 9);
+
+      if (!puz.IsEvaluated()) return true;
+      const PuzzleProfile & profile = puz.GetProfile();
+      int total_moves = 0;
+      int max_level = 0;
+      for (int i = 0; i < profile.GetSize(); i++) {
+        total_moves += profile.GetCount(i);
+        max_level = std::max(max_level, profile.GetLevel(i));
+      }
+      record[FLAGS_POS] = HAS_PROFILE | (profile.IsSolved() ? SOLVED : 0);
+      record[SOLUTIONS_POS] = (uint8_t) (int8_t) std::min(profile.GetSolutionCount(), 127);
+      WriteField<uint16_t>(record, STEPS_POS, (uint16_t) std::min(profile.GetSize(), 65535));
+      WriteField<uint16_t>(record, MOVES_POS, (uint16_t) std::min(total_moves, 65535));
+      WriteField<float>(record, FITNESS_POS, (float) puz.GetFitness());
+      record[MAX_LEVEL_POS] = (uint8_t) max_level;
+      return true;
+    }
+  }
+
+  // A read-only view of one record in a corpus; valid as long as the reader stays open.
+  class SudokuView {
+  private:
+    const uint8_t * record;
+
+  public:
+    SudokuView(const uint8_t * in_record) : record(in_record) { ; }
+    SudokuView(const SudokuView &) = default;
+    SudokuView & operator=(const SudokuView &) = default;
+
+    int GetCell(int id) const { return (record[corpus::CELLS_POS + id/2] >> (4 * (id & 1))) & 15; }
+    bool GetStart(int id) const { return GetStartMask().Has(id); }
+    char GetSymbol(int state) const { return (char) record[corpus::SYMBOLS_POS + state]; }
+    char GetCellSymbol(int id) const { return GetStart(id) ? GetSymbol(GetCell(id)) : '-'; }
+    CellMask GetStartMask() const {
+      return CellMask(corpus::ReadField<uint64_t>(record, corpus::MASK_POS),
+                      corpus::ReadField<uint64_t>(record, corpus::MASK_POS + 8));
+    }
+
+    // Profile summary; only meaningful if HasProfile().
+    bool HasProfile() const { return record[corpus::FLAGS_POS] & corpus::HAS_PROFILE; }
+    bool IsSolved() const { return record[corpus::FLAGS_POS] & corpus::SOLVED; }
+    int GetSolutionCount() const { return (int8_t) record[corpus::SOLUTIONS_POS]; }
+    int GetNumSteps() const { return corpus::ReadField<uint16_t>(record, corpus::STEPS_POS); }
+    int GetTotalMoves() const { return corpus::ReadField<uint16_t>(record, corpus::MOVES_POS); }
+    double GetFitness() const { return corpus::ReadField<float>(record, corpus::FITNESS_POS); }
+    int GetMaxLevel() const { return record[corpus::MAX_LEVEL_POS]; }
+
+    // Build a full Sudoku from this record (the profile is recalculated when needed).
+    void CopyTo(Sudoku & puz) const {
+      std::array<int,81> cells;
+      std::array<char,9> symbols;
+      for (int i = 0; i < 81; i++) cells[i] = GetCell(i);
+      for (int s = 0; s < 9; s++) symbols[s] = GetSymbol(s);
+      puz.SetPuzzle(cells, symbols, GetStartMask());
+    }
+    Sudoku ToSudoku() const {
+      Sudoku puz;
+      CopyTo(puz);
+      return puz;
+    }
+  };
+
+  class CorpusWriter {
+  private:
+    std::ofstream out;
+    size_t count;
+
+  public:
+    CorpusWriter() : count(0) { ; }
+    CorpusWriter(const std::string & filename) : count(0) { Open(filename); }
+    CorpusWriter(const CorpusWriter &) = delete;
+    ~CorpusWriter() { Close(); }
+    CorpusWriter & operator=(const CorpusWriter &) = delete;
+
+    bool IsOpen() const { return out.is_open(); }
+    size_t GetCount() const { return count; }
+
+    // Start a new corpus file (replacing any existing file); return false on failure.
+    bool Open(const std::string & filename) {
+      Close();
+      out.open(filename, std::ios::binary | std::ios::trunc);
+      if (!out) return false;
+      std::array<uint8_t, corpus::HEADER_SIZE> header{};
+      std::memcpy(header.data(), corpus::MAGIC, 8);
+      corpus::WriteField<uint32_t>(header.data(), 8, corpus::VERSION);
+      corpus::WriteField<uint32_t>(header.data(), 12, (uint32_t) corpus::RECORD_SIZE);
+      out.write((const char *) header.data(), header.size());
+      return (bool) out;
+    }
+
+    // Append a puzzle; return false on failure, or if it has no full solution grid.
+    bool Write(const Sudoku & puz) {
+      std::array<uint8_t, corpus::RECORD_SIZE> record;
+      if (!corpus::EncodeRecord(puz, record.data())) return false;
+      out.write((const char *) record.data(), record.size());
+      if (!out) return false;
+      count++;
+      return true;
+    }
+
+    void Close() {
+      if (out.is_open()) out.close();
+      count = 0;
+    }
+  };
+
+  class CorpusReader {
+  private:
+    const uint8_t * data;       // Start of the file contents.
+    size_t num_bytes;
+    size_t num_records;
+#ifdef PZE_CORPUS_MMAP
+    void * map;
+#else
+    std::vector<uint8_t> buffer;
+#endif
+
+    // Check the header and count the records; return false if this is not a corpus file.
+    bool ReadHeader() {
+      if (num_bytes < corpus::HEADER_SIZE || std::memcmp(data, corpus::MAGIC, 8) != 0
+          || corpus::ReadField<uint32_t>(data, 8) != corpus::VERSION
+          || corpus::ReadField<uint32_t>(data, 12) != corpus::RECORD_SIZE) {
+        return false;
+      }
+      num_records = (num_bytes - corpus::HEADER_SIZE) / corpus::RECORD_SIZE;
+      return true;
+    }
+
+  public:
+    CorpusReader() : data(nullptr), num_bytes(0), num_records(0)
+#ifdef PZE_CORPUS_MMAP
+      , map(nullptr)
+#endif
+    { ; }
+    CorpusReader(const std::string & filename) : CorpusReader() { Open(filename); }
+    CorpusReader(const CorpusReader &) = delete;
+    ~CorpusReader() { Close(); }
+    CorpusReader & operator=(const CorpusReader &) = delete;
+
+    bool IsOpen() const { return data != nullptr; }
+    size_t GetSize() const { return num_records; }
+
+    SudokuView operator[](size_t id) const {
+      emp_assert(id < num_records, id, num_records);
+      return SudokuView(data + corpus::HEADER_SIZE + id * corpus::RECORD_SIZE);
+    }
+
+    // Open a corpus file; return false (leaving the reader closed) on failure.
+    bool Open(const std::string & filename) {
+      Close();
+#ifdef PZE_CORPUS_MMAP
+      const int fd = open(filename.c_str(), O_RDONLY);
+      if (fd < 0) return false;
+      struct stat info;
+      if (fstat(fd, &info) != 0 || info.st_size == 0) { close(fd); return false; }
+      num_bytes = (size_t) info.st_size;
+      map = mmap(nullptr, num_bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+      close(fd);                  // The mapping stays valid without the descriptor.
+      if (map == MAP_FAILED) { map = nullptr; num_bytes = 0; return false; }
+      data = (const uint8_t *) map;
+#else
+      std::ifstream in(filename, std::ios::binary);
+      if (!in) return false;
+      buffer.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+      if (buffer.empty()) return false;
+      num_bytes = buffer.size();
+      data = buffer.data();
+#endif
+      if (!ReadHeader()) { Close(); return false; }
+      return true;
+    }
+
+    void Close() {
+#ifdef PZE_CORPUS_MMAP
+      if (map) munmap(map, num_bytes);
+      map = nullptr;
+#else
+      buffer.clear();
+#endif
+      data = nullptr;
+      num_bytes = 0;
+      num_records = 0;
+    }
+  };
+
+}
+
+#endif
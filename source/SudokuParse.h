@@ -0,0 +1,166 @@
+//  This file is part of PuzzleEngine, https://github.com/mercere99/PuzzleEngine/
+//  Copyright (C) Michigan State University, 2015.
+//  Released under the MIT Software license; see doc/LICENSE
+//
+//
+//  Bulk loading of puzzles in the common one-line format.
+//
+//  Each puzzle is a line whose first 81 characters are its cells, row by row: '1'-'9' for
+//  a starting value and '.', '0', or '-' for a blank.  Anything after the 81st character
+//  (a rating, a solution column, a '\r') is ignored, as are empty lines and lines starting
+//  with '#'.  Other lines are counted as bad and skipped.
+//
+//  Unlike Sudoku::Load(), which reads a character at a time from a stream and maps symbols
+//  in order of first appearance, the parser works directly on a buffer in memory (such as
+//  a whole file, or a mapped one), classifies 16 characters at a time with SSE2, and uses
+//  the default symbols.  Filling in the blank cells from a solution is optional; skipping
+//  it leaves puzzles that are ready for CalcProfile() and CountSolutions().
+
+#ifndef PZE_SUDOKU_PARSE_H
+#define PZE_SUDOKU_PARSE_H
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "Sudoku.h"
+#include "ThreadPool.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define PZE_PARSE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace pze {
+namespace parse {
+
+  static constexpr size_t LINE_CELLS = 81;
+
+  // Classify one cell character: 0-8 for a digit, -1 for a blank, -2 for anything else.
+  inline int CharToState(char c) {
+    if (c >= '1' && c <= '9') return c - '1';
+    if (c == '.' || c == '0' || c == '-') return -1;
+    return -2;
+  }
+
+#ifdef PZE_PARSE_SSE2
+  // Classify 16 characters: store their states (or -1) and return a bit for each valid one.
+  inline uint32_t ClassifyChunk(const char * text, int8_t * states) {
+    const __m128i c = _mm_loadu_si128((const __m128i *) text);
+    const __m128i is_digit = _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('0')),
+                                           _mm_cmplt_epi8(c, _mm_set1_epi8('9' + 1)));
+    const __m128i is_blank = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(c, _mm_set1_epi8('.')),
+                                                       _mm_cmpeq_epi8(c, _mm_set1_epi8('0'))),
+                                          _mm_cmpeq_epi8(c, _mm_set1_epi8('-')));
+    // Digits become c - '1'; everything else becomes -1 (all bits set).
+    const __m128i value = _mm_sub_epi8(c, _mm_set1_epi8('1'));
+    _mm_storeu_si128((__m128i *) states,
+                     _mm_or_si128(_mm_and_si128(is_digit, value), _mm_andnot_si128(is_digit, _mm_set1_epi8(-1))));
+    return (uint32_t) _mm_movemask_epi8(_mm_or_si128(is_digit, is_blank));
+  }
+#endif
+
+  // Parse the 81 cells at the start of text (which must have at least 81 characters).
+  // Return false if any of them is not a digit or blank.
+  inline bool ParseCells(const char * text, std::array<int,81> & states) {
+#ifdef PZE_PARSE_SSE2
+    std::array<int8_t, 80> packed;
+    for (int chunk = 0; chunk < 5; chunk++) {
+      if (ClassifyChunk(text + chunk*16, packed.data() + chunk*16) != 0xFFFF) return false;
+    }
+    states[80] = CharToState(text[80]);
+    if (states[80] == -2) return false;
+    for (int i = 0; i < 80; i++) states[i] = packed[i];
+#else
+    for (int i = 0; i < 81; i++) {
+      states[i] = CharToState(text[i]);
+      if (states[i] == -2) return false;
+    }
+#endif
+    return true;
+  }
+
+  // Find the first line boundary at or after pos that is a safe place to split a buffer.
+  inline size_t NextLineStart(const char * text, size_t size, size_t pos) {
+    if (pos == 0) return 0;
+    if (pos >= size) return size;
+    const void * newline = std::memchr(text + pos - 1, '\n', size - pos + 1);
+    return newline ? (size_t) ((const char *) newline - text) + 1 : size;
+  }
+
+}
+
+  // Parse every puzzle line in text[0, size), appending them to out.  If solve is set,
+  // blank cells are filled in from a solution (as Sudoku::Load() does).  Return the number
+  // of puzzles added; bad lines (and puzzles with no solution, when solving) are skipped
+  // and counted in bad_lines, if provided.
+  inline size_t ParsePuzzles(const char * text, size_t size, std::vector<Sudoku> & out,
+                             bool solve=false, size_t * bad_lines=nullptr) {
+    const size_t start_count = out.size();
+    std::array<int,81> states;
+    size_t pos = 0;
+    while (pos < size) {
+      const char * line = text + pos;
+      const void * newline = std::memchr(line, '\n', size - pos);
+      const size_t line_size = newline ? (size_t) ((const char *) newline - line) : size - pos;
+      pos += line_size + 1;
+
+      if (line_size == 0 || line[0] == '#' || (line_size == 1 && line[0] == '\r')) continue;
+      if (line_size < parse::LINE_CELLS || !parse::ParseCells(line, states)) {
+        if (bad_lines) (*bad_lines)++;
+        continue;
+      }
+      out.emplace_back();
+      if (!out.back().SetStartCells(states, solve)) {
+        out.pop_back();
+        if (bad_lines) (*bad_lines)++;
+      }
+    }
+    return out.size() - start_count;
+  }
+
+  // As above, but split the buffer at line boundaries and parse the pieces in parallel.
+  // Puzzles keep the order in which they appear in the buffer.
+  inline size_t ParsePuzzles(const char * text, size_t size, std::vector<Sudoku> & out,
+                             ThreadPool & pool, bool solve=false, size_t * bad_lines=nullptr) {
+    const size_t num_parts = pool.GetNumThreads() * 4;
+    std::vector<std::vector<Sudoku>> parts(num_parts);
+    std::vector<size_t> part_bad(num_parts, 0);
+    pool.ParallelFor(num_parts, [&](size_t part){
+        const size_t begin = parse::NextLineStart(text, size, size * part / num_parts);
+        const size_t end = parse::NextLineStart(text, size, size * (part + 1) / num_parts);
+        if (begin < end) ParsePuzzles(text + begin, end - begin, parts[part], solve, &part_bad[part]);
+      }, 1);
+
+    const size_t start_count = out.size();
+    size_t total = start_count;
+    for (const auto & part : parts) total += part.size();
+    out.reserve(total);
+    for (size_t part = 0; part < num_parts; part++) {
+      out.insert(out.end(), std::make_move_iterator(parts[part].begin()),
+                 std::make_move_iterator(parts[part].end()));
+      if (bad_lines) *bad_lines += part_bad[part];
+    }
+    return out.size() - start_count;
+  }
+
+  inline size_t ParsePuzzles(const std::string & text, std::vector<Sudoku> & out,
+                             bool solve=false, size_t * bad_lines=nullptr) {
+    return ParsePuzzles(text.data(), text.size(), out, solve, bad_lines);
+  }
+
+  // Read a whole puzzle file and parse it; return the number of puzzles added.
+  inline size_t LoadPuzzleFile(const std::string & filename, std::vector<Sudoku> & out,
+                               bool solve=false, size_t * bad_lines=nullptr) {
+    std::ifstream in(filename, std::ios::binary);
+    if (!in) return 0;
+    const std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    return ParsePuzzles(text, out, solve, bad_lines);
+  }
+
+}
+
+#endif
@@ -0,0 +1,330 @@
+//  This file is part of PuzzleEngine, https://github.com/mercere99/PuzzleEngine/
+//  Copyright (C) Michigan State University, 2015.
+//  Released under the MIT Software license; see doc/LICENSE
+//
+//
+//  This class is an alternative, digit-major layout for a sudoku solving state.
+//
+//  Rather than storing nine option bits for each of 81 cells (as SudokuState does),
+//  SudokuPlaneState stores one 81-bit plane per digit, marking which cells can still
+//  hold that digit.  Setting a cell is then a handful of masked ANDs against a
+//  precomputed peer mask, and region checks are popcounts of a plane against a
+//  region mask.  The public interface mirrors the singles part of Sudoku::SudokuState
+//  (dirty-only scans, MoveBuffer versions of each technique, and contradiction tracking),
+//  and SudokuPlaneState::SinglesLadder runs the same singles ladder as
+//  Sudoku::SinglesLadder, so code templated on the state type can use either one for that.
+//
+//  It is NOT a drop-in replacement for SudokuState beyond singles: it has no subset or fish
+//  techniques and no brute-force search (ForceSolve(), CountSolutions()), so the full
+//  Sudoku::DefaultLadder and Sudoku::RunProfile() (and thus CalcProfile()) cannot run on
+//  it.  It is currently used for benchmarking and consistency checks only.
+
+#ifndef PZE_SUDOKU_PLANES_H
+#define PZE_SUDOKU_PLANES_H
+
+#include <array>
+#include <iostream>
+#include <vector>
+#include "base/assert.hpp"
+#include "CellMask.h"
+#include "MoveBuffer.h"
+#include "Sudoku.h"
+
+namespace pze {
+
+  namespace internal {
+    // Which region ids (row, column, box) is a cell a member of?
+    constexpr int RowOf(int cell) { return cell / 9; }
+    constexpr int ColOf(int cell) { return 9 + cell % 9; }
+    constexpr int BoxOf(int cell) { return 18 + (cell / 27) * 3 + (cell % 9) / 3; }
+
+    constexpr std::array<CellMask,27> BuildRegionMasks() {
+      std::array<CellMask,27> masks;
+      for (int cell = 0; cell < 81; cell++) {
+        masks[RowOf(cell)].Set(cell);
+        masks[ColOf(cell)].Set(cell);
+        masks[BoxOf(cell)].Set(cell);
+      }
+      return masks;
+    }
+
+    constexpr std::array<CellMask,81> BuildPeerMasks() {
+      std::array<CellMask,27> region_masks = BuildRegionMasks();
+      std::array<CellMask,81> masks;
+      for (int cell = 0; cell < 81; cell++) {
+        masks[cell] = region_masks[RowOf(cell)] | region_masks[ColOf(cell)] | region_masks[BoxOf(cell)];
+        masks[cell].Clear(cell);
+      }
+      return masks;
+    }
+  }
+
+  class SudokuPlaneState : public PuzzleState {
+  public:
+    using PuzzleState::Move;
+  private:
+    static constexpr int NUM_STATES = 9;
+    static constexpr int NUM_CELLS = 81;
+    static constexpr int NUM_REGIONS = 27;
+
+    std::array<char,NUM_CELLS> value;          // Known value for cells; -1 = unknown
+    std::array<CellMask,NUM_STATES> planes;    // Which cells can still hold each state?
+    const Sudoku* puzzle;                      // Pointer back to original puzzle
+    CellMask dirty_cells;                      // Changed since the last dirty cell scan
+    CellMask dirty_region_cells;               // Changed since the last dirty region scan
+    bool contradiction;                        // Has an unset cell run out of options (or a Set() failed)?
+
+    // Cells in each region, and the 20 other cells that each cell shares a region with.
+    static constexpr std::array<CellMask,NUM_REGIONS> region_masks = internal::BuildRegionMasks();
+    static constexpr std::array<CellMask,NUM_CELLS> peer_masks = internal::BuildPeerMasks();
+
+    // Which cells have exactly one option left?
+    CellMask FindSingleOptionCells() const {
+      CellMask opt_any;    // Cells with at least one option.
+      CellMask opt_multi;  // Cells with at least two options.
+      for (const CellMask & plane : planes) {
+        opt_multi |= opt_any & plane;
+        opt_any |= plane;
+      }
+      return opt_any & ~opt_multi;
+    }
+
+    // Which cells have at least one option left?
+    CellMask FindOptionCells() const {
+      CellMask opt_any;
+      for (const CellMask & plane : planes) opt_any |= plane;
+      return opt_any;
+    }
+
+    // Note that the options of some cells have changed.
+    void MarkDirty(const CellMask & cells) {
+      dirty_cells |= cells;
+      dirty_region_cells |= cells;
+    }
+
+  public:
+    SudokuPlaneState(const Sudoku * p) : puzzle(p) { Clear(); }
+    SudokuPlaneState(const Sudoku & p) : puzzle(&p) { Clear(); }
+    SudokuPlaneState(const Sudoku::SudokuState & state)
+      : puzzle(state.GetPuzzle()), contradiction(state.HasContradiction()) {
+      for (int cell = 0; cell < NUM_CELLS; cell++) {
+        value[cell] = (char) state.GetValue(cell);
+        const uint32_t opts = state.GetOptions(cell);
+        for (int s = 0; s < NUM_STATES; s++) {
+          if (opts & (1 << s)) planes[s].Set(cell);
+        }
+      }
+      MarkAllDirty();
+    }
+    SudokuPlaneState(const SudokuPlaneState &) = default;
+    ~SudokuPlaneState() { ; }
+
+    SudokuPlaneState & operator=(const SudokuPlaneState &) = default;
+
+    int GetValue(int cell) const { return value[cell]; }
+    uint32_t GetOptions(int cell) const {
+      uint32_t opts = 0;
+      for (int s = 0; s < NUM_STATES; s++) opts |= (uint32_t) planes[s].Has(cell) << s;
+      return opts;
+    }
+    int CountOptions(int cell) const {
+      emp_assert(cell >= 0 && cell < 81, cell);
+      return __builtin_popcount(GetOptions(cell));
+    }
+    const CellMask & GetPlane(int state) const { return planes[state]; }
+    const Sudoku * const GetPuzzle() const { return puzzle; }
+    bool HasOption(int cell, int state) const {
+      emp_assert(cell >= 0 && cell < 81, cell);
+      emp_assert(state >= 0 && state < 9, state);
+      return planes[state].Has(cell);
+    }
+    bool IsSet(int cell) const { return value[cell] != -1; }
+    bool HasContradiction() const { return contradiction; }
+    bool IsSolved() const { return FindOptionCells().None(); }
+
+    // How many cells in a region can still hold a given state?
+    int CountRegionOptions(int region_id, int state) const {
+      return (planes[state] & region_masks[region_id]).Count();
+    }
+
+    void Clear() override {
+      value.fill(-1);
+      planes.fill(CellMask::Range(NUM_CELLS));
+      contradiction = false;
+      MarkAllDirty();
+    }
+
+    // Force the next dirty-only scans to look at the whole board.
+    void MarkAllDirty() {
+      dirty_cells = dirty_region_cells = CellMask::Range(NUM_CELLS);
+    }
+
+    const CellMask & GetDirtyCells() const { return dirty_cells; }
+
+    // Find the next available option for a cell.
+    int FindNext(int cell) const {
+      for (int s = 0; s < NUM_STATES; s++) if (planes[s].Has(cell)) return s;
+      return -1;
+    }
+
+    // Set the value of an individual cell; remove option from linked cells.  As in
+    // SudokuState, setting a state that has been ruled out is a contradiction, and leaves
+    // the cell as it was.
+    void Set(int cell, int state) override {
+      emp_assert(cell >= 0 && cell < NUM_CELLS);
+      emp_assert(state >= 0 && state < NUM_STATES);
+
+      if (value[cell] == state) return;      // If state is already set, SKIP!
+      if (!HasOption(cell,state)) {
+        contradiction = true;
+        return;
+      }
+      value[cell] = (char) state;            // Store found value!
+
+      // No options are available to a locked cell, and no peer can share its state.
+      const CellMask cell_mask = CellMask::Single(cell);
+      const CellMask losing = planes[state] & peer_masks[cell];
+      MarkDirty(cell_mask | losing);
+      for (CellMask & plane : planes) plane.Remove(cell_mask);
+      planes[state].Remove(peer_masks[cell]);
+      if (losing.Any() && (losing & ~FindOptionCells()).Any()) contradiction = true;
+    }
+
+    // Remove a symbol option from a particular cell.
+    void Block(int cell, int state) override {
+      if (!planes[state].Has(cell)) return;  // Already blocked; nothing changes.
+      planes[state].Clear(cell);
+      MarkDirty(CellMask::Single(cell));
+      if (value[cell] == -1 && GetOptions(cell) == 0) contradiction = true;
+    }
+
+    // Operate on a "move" object.
+    void Move(const PuzzleMove & move) override {
+      emp_assert(move.GetID() >= 0 && move.GetID() < NUM_CELLS, move.GetID());
+      emp_assert(move.GetState() >= 0 && move.GetState() < NUM_STATES, move.GetState());
+
+      switch (move.GetType()) {
+      case PuzzleMove::SET_STATE:   Set(move.GetID(), move.GetState());   break;
+      case PuzzleMove::BLOCK_STATE: Block(move.GetID(), move.GetState()); break;
+      default:
+        emp_assert(false);   // One of the previous move options should have been triggered!
+      }
+    }
+
+    // Apply a whole buffer of moves.
+    void Move(const MoveBuffer & moves) {
+      for (const PackedMove move : moves) {
+        if (move.IsSet()) SudokuPlaneState::Set(move.GetID(), move.GetState());
+        else SudokuPlaneState::Block(move.GetID(), move.GetState());
+      }
+    }
+
+    // Print the current state of the puzzle, including all options available.
+    void Print(const std::array<char,9> & symbols, std::ostream & out=std::cout) {
+      out << " +-----------------------+-----------------------+-----------------------+"
+          << std::endl;
+      for (int r = 0; r < 9; r++) {
+        for (int s = 0; s < 9; s+=3) {
+          for (int c = 0; c < 9; c++) {
+            int id = r*9+c;
+            if (c%3==0) out << " |";
+            else out << "  ";
+            if (value[id] == -1) {
+              out << " " << (char) (HasOption(id,s)   ? symbols[s] : '.')
+                  << " " << (char) (HasOption(id,s+1) ? symbols[s+1] : '.')
+                  << " " << (char) (HasOption(id,s+2) ? symbols[s+2] : '.');
+            } else {
+              if (s==0) out << "      ";
+              if (s==3) out << "   " << symbols[value[id]] << "  ";
+              if (s==6) out << "      ";
+            }
+          }
+          out << " |" << std::endl;
+        }
+        if (r%3==2) {
+          out << " +-----------------------+-----------------------+-----------------------+";
+        }
+        else {
+          out << " |                       |                       |                       |";
+        }
+        out << std::endl;
+      }
+    }
+    void Print(std::ostream & out=std::cout) override { Print(puzzle->GetSymbols(), out); }
+
+    // If there's only one state a cell can be, pick it!
+    // If dirty_only is set, only cells that changed since the last dirty scan are checked;
+    // cells that produce a move stay dirty so they are reported again until they are set.
+    void Solve_FindLastCellState(MoveBuffer & moves, bool dirty_only=false) {
+      CellMask found = FindSingleOptionCells();
+      if (dirty_only) {
+        found &= dirty_cells;
+        dirty_cells = found;
+      }
+      found.ForEach([this, &moves](int cell){ moves.AddSet(cell, FindNext(cell)); });
+    }
+
+    std::vector<PuzzleMove> Solve_FindLastCellState(bool dirty_only=false) {
+      MoveBuffer moves;
+      Solve_FindLastCellState(moves, dirty_only);
+      return moves.ToVector();
+    }
+
+    // If there's only one cell that can have a certain state in a region, choose it!
+    // If dirty_only is set, only regions with a cell that changed since the last dirty scan
+    // are checked; regions that produce moves stay dirty so they are reported again until
+    // resolved.
+    void Solve_FindLastRegionState(MoveBuffer & moves, bool dirty_only=false) {
+      CellMask pending;
+      for (int region_id = 0; region_id < NUM_REGIONS; region_id++) {
+        const CellMask & region = region_masks[region_id];
+        if (dirty_only && (dirty_region_cells & region).None()) continue;
+
+        uint32_t opt_once = 0;   // Which states have exactly one cell in this region?
+        CellMask once_cells;     // Which cells hold those states?
+        for (int s = 0; s < NUM_STATES; s++) {
+          const CellMask found = planes[s] & region;
+          if (found.Count() == 1) {
+            opt_once |= 1 << s;
+            once_cells |= found;
+          }
+        }
+        if (opt_once == 0) continue;
+        pending |= region;
+
+        // Report cells in region order, using the lowest unique state in each.
+        once_cells.ForEach([this, &moves, opt_once](int cell){
+            uint32_t opts = opt_once;
+            while (!planes[__builtin_ctz(opts)].Has(cell)) opts &= opts - 1;
+            moves.AddSet(cell, __builtin_ctz(opts));
+          });
+      }
+      if (dirty_only) dirty_region_cells = pending;
+    }
+
+    std::vector<PuzzleMove> Solve_FindLastRegionState(bool dirty_only=false) {
+      MoveBuffer moves;
+      Solve_FindLastRegionState(moves, dirty_only);
+      return moves.ToVector();
+    }
+
+    // The singles techniques, as rungs for a SolveLadder (matching Sudoku's).
+    struct LastCellTechnique {
+      static constexpr int LEVEL = Sudoku::LEVEL_LAST_CELL;
+      static constexpr const char * NAME = "LastCell";
+      static void Find(SudokuPlaneState & state, MoveBuffer & moves) { state.Solve_FindLastCellState(moves, true); }
+    };
+
+    struct LastRegionTechnique {
+      static constexpr int LEVEL = Sudoku::LEVEL_LAST_REGION;
+      static constexpr const char * NAME = "LastRegion";
+      static void Find(SudokuPlaneState & state, MoveBuffer & moves) { state.Solve_FindLastRegionState(moves, true); }
+    };
+
+    // The same ladder as Sudoku::SinglesLadder.
+    using SinglesLadder = SolveLadder<LastCellTechnique, LastRegionTechnique>;
+  };
+
+}
+
+#endif
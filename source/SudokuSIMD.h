@@ -0,0 +1,368 @@
+//  This file is part of PuzzleEngine, https://github.com/mercere99/PuzzleEngine/
+//  Copyright (C) Michigan State University, 2015.
+//  Released under the MIT Software license; see doc/LICENSE
+//
+//
+//  Vectorized kernels for region-wide scans of a 9x9 sudoku options array.
+//
+//  Each kernel takes the 81 per-cell option words of a SudokuState and computes a
+//  summary for many regions at once:
+//  * FindRegionOnce() - for all 27 regions, which states appear in exactly one cell
+//                       (hidden singles).
+//  * FindOverlapOnce() - for all 54 row/column-by-box overlaps, which states are
+//                        available; for each of the 18 rows/columns, which states are
+//                        confined to a single box (claiming); and for each box, which
+//                        states are confined to a single row or column (pointing).
+//  * FindStatePositions() - for each state and each of the 27 regions, the positions
+//                           in the region where the state is still an option (used by
+//                           hidden subsets and fish).
+//
+//  Scalar, SSE4.1, and AVX2 versions are provided (FindStatePositions() is table-driven
+//  and only has a scalar version).  The best version supported by
+//  the running CPU is selected the first time a kernel is used; SetLevel() can force
+//  a lower level (e.g., for benchmarking).  Non-x86 builds (including the web build)
+//  only have the scalar version.
+
+#ifndef PZE_SUDOKU_SIMD_H
+#define PZE_SUDOKU_SIMD_H
+
+#include <array>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define PZE_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+namespace pze {
+namespace simd {
+
+  enum class Level { SCALAR=0, SSE4, AVX2 };
+
+  static constexpr int NUM_REGIONS = 27;
+  static constexpr int NUM_OVERLAPS = 54;
+  static constexpr int NUM_LINES = 18;       // Rows and columns, each split into three overlaps.
+  static constexpr int NUM_BOX_GROUPS = 18;  // Each box's row segments, then its column segments.
+
+  // Which cell is at each position of each region?  Stored position-major, so that
+  // region_cells[p][r] is position p of region r (padded to 32 regions with cell 0).
+  constexpr std::array<std::array<int,32>,9> BuildRegionCells() {
+    std::array<std::array<int,32>,9> cells{};
+    for (int p = 0; p < 9; p++) {
+      for (int r = 0; r < 9; r++) {
+        cells[p][r] = r*9 + p;                                             // Rows
+        cells[p][9+r] = p*9 + r;                                           // Columns
+        cells[p][18+r] = (r/3)*27 + (r%3)*3 + (p/3)*9 + p%3;               // Boxes
+      }
+    }
+    return cells;
+  }
+
+  // Which cells are in each overlap?  overlap_cells[k][i] is cell k of overlap i
+  // (padded to 56 overlaps with cell 0).
+  constexpr std::array<std::array<int,56>,3> BuildOverlapCells() {
+    std::array<std::array<int,56>,3> cells{};
+    for (int k = 0; k < 3; k++) {
+      for (int i = 0; i < 27; i++) {
+        cells[k][i] = i*3 + k;                                             // Row segments
+        cells[k][27+i] = ((i%3)*3 + k) * 9 + i/3;                          // Column segments
+      }
+    }
+    return cells;
+  }
+
+  // Which overlaps make up each box group?  box_group_overlaps[k][g] is overlap k of
+  // group g: groups 0-8 are the row segments of boxes 0-8, and groups 9-17 are their
+  // column segments (padded to 24 groups with overlap 0).
+  constexpr std::array<std::array<int,24>,3> BuildBoxGroupOverlaps() {
+    std::array<std::array<int,24>,3> ids{};
+    for (int k = 0; k < 3; k++) {
+      for (int b = 0; b < 9; b++) {
+        ids[k][b] = ((b/3)*3 + k) * 3 + b%3;                               // Row segments
+        ids[k][9+b] = 27 + ((b%3)*3 + k) * 3 + b/3;                        // Column segments
+      }
+    }
+    return ids;
+  }
+
+  static constexpr std::array<std::array<int,32>,9> region_cells = BuildRegionCells();
+  static constexpr std::array<std::array<int,56>,3> overlap_cells = BuildOverlapCells();
+  static constexpr std::array<std::array<int,24>,3> box_group_overlaps = BuildBoxGroupOverlaps();
+
+  // --- Scalar kernels ---
+
+  inline void FindRegionOnce_Scalar(const uint32_t * options, uint32_t * opt_once) {
+    for (int r = 0; r < NUM_REGIONS; r++) {
+      uint32_t opt_any = 0;     // Is a state an option in ANY cell?
+      uint32_t opt_multi = 0;   // Is a state an option in MULTIPLE cells?
+      for (int p = 0; p < 9; p++) {
+        const uint32_t opts = options[region_cells[p][r]];
+        opt_multi |= opts & opt_any;
+        opt_any |= opts;
+      }
+      opt_once[r] = opt_any & ~opt_multi;
+    }
+  }
+
+  inline void FindOverlapOnce_Scalar(const uint32_t * options, uint32_t * overlap_options,
+                                     uint32_t * line_once, uint32_t * box_once) {
+    for (int i = 0; i < NUM_OVERLAPS; i++) {
+      overlap_options[i] = options[overlap_cells[0][i]] | options[overlap_cells[1][i]]
+        | options[overlap_cells[2][i]];
+    }
+    for (int l = 0; l < NUM_LINES; l++) {
+      const uint32_t a = overlap_options[l*3], b = overlap_options[l*3+1], c = overlap_options[l*3+2];
+      line_once[l] = (a ^ b ^ c) & ~(a & b & c);
+    }
+    for (int g = 0; g < NUM_BOX_GROUPS; g++) {
+      const uint32_t a = overlap_options[box_group_overlaps[0][g]];
+      const uint32_t b = overlap_options[box_group_overlaps[1][g]];
+      const uint32_t c = overlap_options[box_group_overlaps[2][g]];
+      box_once[g] = (a ^ b ^ c) & ~(a & b & c);
+    }
+  }
+
+  // Spread the nine option bits of a cell so that bit s lands at the start of a 9-bit field
+  // for state s: states 0-5 go in the low word (bit 9s), states 6-8 in the high word.
+  constexpr std::array<std::array<uint64_t,512>,2> BuildStateSpread() {
+    std::array<std::array<uint64_t,512>,2> spread{};
+    for (uint32_t opts = 0; opts < 512; opts++) {
+      for (int s = 0; s < 9; s++) {
+        if (opts & (1u << s)) spread[s / 6][opts] |= 1ull << (9 * (s % 6));
+      }
+    }
+    return spread;
+  }
+
+  static constexpr std::array<std::array<uint64_t,512>,2> state_spread = BuildStateSpread();
+
+  // Table-driven: every position of a region adds its spread options (shifted by the
+  // position) into all nine state fields at once.  Fast enough that no vector versions
+  // are needed.
+  inline void FindStatePositions_Scalar(const uint32_t * options, uint32_t * positions) {
+    for (int r = 0; r < NUM_REGIONS; r++) {
+      uint64_t lo = 0, hi = 0;
+      for (int p = 0; p < 9; p++) {
+        const uint32_t opts = options[region_cells[p][r]];
+        lo |= state_spread[0][opts] << p;
+        hi |= state_spread[1][opts] << p;
+      }
+      for (int s = 0; s < 6; s++) positions[s*NUM_REGIONS + r] = (uint32_t) (lo >> (9*s)) & 511;
+      for (int s = 6; s < 9; s++) positions[s*NUM_REGIONS + r] = (uint32_t) (hi >> (9*(s-6))) & 511;
+    }
+  }
+
+#ifdef PZE_SIMD_X86
+
+  // --- SSE4.1 kernels (four regions per vector) ---
+
+  __attribute__((target("sse4.1")))
+  inline __m128i Load4_SSE4(const uint32_t * options, const int * ids) {
+    __m128i v = _mm_cvtsi32_si128((int) options[ids[0]]);
+    v = _mm_insert_epi32(v, (int) options[ids[1]], 1);
+    v = _mm_insert_epi32(v, (int) options[ids[2]], 2);
+    v = _mm_insert_epi32(v, (int) options[ids[3]], 3);
+    return v;
+  }
+
+  __attribute__((target("sse4.1")))
+  inline void FindRegionOnce_SSE4(const uint32_t * options, uint32_t * opt_once) {
+    alignas(16) uint32_t result[28];
+    for (int r = 0; r < 28; r += 4) {
+      __m128i opt_any = _mm_setzero_si128();
+      __m128i opt_multi = _mm_setzero_si128();
+      for (int p = 0; p < 9; p++) {
+        const __m128i opts = Load4_SSE4(options, &region_cells[p][r]);
+        opt_multi = _mm_or_si128(opt_multi, _mm_and_si128(opts, opt_any));
+        opt_any = _mm_or_si128(opt_any, opts);
+      }
+      _mm_store_si128((__m128i *) &result[r], _mm_andnot_si128(opt_multi, opt_any));
+    }
+    for (int r = 0; r < NUM_REGIONS; r++) opt_once[r] = result[r];
+  }
+
+  __attribute__((target("sse4.1")))
+  inline void FindOverlapOnce_SSE4(const uint32_t * options, uint32_t * overlap_options,
+                                   uint32_t * line_once, uint32_t * box_once) {
+    alignas(16) uint32_t ov[56];
+    for (int i = 0; i < 56; i += 4) {
+      const __m128i v = _mm_or_si128(_mm_or_si128(Load4_SSE4(options, &overlap_cells[0][i]),
+                                                  Load4_SSE4(options, &overlap_cells[1][i])),
+                                     Load4_SSE4(options, &overlap_cells[2][i]));
+      _mm_store_si128((__m128i *) &ov[i], v);
+    }
+    for (int i = 0; i < NUM_OVERLAPS; i++) overlap_options[i] = ov[i];
+
+    alignas(16) uint32_t result[20];
+    for (int l = 0; l < 20; l += 4) {
+      const int lines[4] = { l, l+1, l+2 < NUM_LINES ? l+2 : 0, l+3 < NUM_LINES ? l+3 : 0 };
+      const __m128i a = _mm_set_epi32(ov[lines[3]*3],   ov[lines[2]*3],   ov[lines[1]*3],   ov[lines[0]*3]);
+      const __m128i b = _mm_set_epi32(ov[lines[3]*3+1], ov[lines[2]*3+1], ov[lines[1]*3+1], ov[lines[0]*3+1]);
+      const __m128i c = _mm_set_epi32(ov[lines[3]*3+2], ov[lines[2]*3+2], ov[lines[1]*3+2], ov[lines[0]*3+2]);
+      const __m128i odd = _mm_xor_si128(_mm_xor_si128(a, b), c);
+      const __m128i all = _mm_and_si128(_mm_and_si128(a, b), c);
+      _mm_store_si128((__m128i *) &result[l], _mm_andnot_si128(all, odd));
+    }
+    for (int l = 0; l < NUM_LINES; l++) line_once[l] = result[l];
+
+    for (int g = 0; g < 20; g += 4) {
+      const __m128i a = Load4_SSE4(ov, &box_group_overlaps[0][g]);
+      const __m128i b = Load4_SSE4(ov, &box_group_overlaps[1][g]);
+      const __m128i c = Load4_SSE4(ov, &box_group_overlaps[2][g]);
+      const __m128i odd = _mm_xor_si128(_mm_xor_si128(a, b), c);
+      const __m128i all = _mm_and_si128(_mm_and_si128(a, b), c);
+      _mm_store_si128((__m128i *) &result[g], _mm_andnot_si128(all, odd));
+    }
+    for (int g = 0; g < NUM_BOX_GROUPS; g++) box_once[g] = result[g];
+  }
+
+  // --- AVX2 kernels (eight regions per vector, using gathers) ---
+
+  __attribute__((target("avx2")))
+  inline __m256i Gather8_AVX2(const uint32_t * base, const int * ids) {
+    const __m256i idx = _mm256_loadu_si256((const __m256i *) ids);
+    return _mm256_i32gather_epi32((const int *) base, idx, 4);
+  }
+
+  __attribute__((target("avx2")))
+  inline void FindRegionOnce_AVX2(const uint32_t * options, uint32_t * opt_once) {
+    alignas(32) uint32_t result[32];
+    for (int r = 0; r < 32; r += 8) {
+      __m256i opt_any = _mm256_setzero_si256();
+      __m256i opt_multi = _mm256_setzero_si256();
+      for (int p = 0; p < 9; p++) {
+        const __m256i opts = Gather8_AVX2(options, &region_cells[p][r]);
+        opt_multi = _mm256_or_si256(opt_multi, _mm256_and_si256(opts, opt_any));
+        opt_any = _mm256_or_si256(opt_any, opts);
+      }
+      _mm256_store_si256((__m256i *) &result[r], _mm256_andnot_si256(opt_multi, opt_any));
+    }
+    for (int r = 0; r < NUM_REGIONS; r++) opt_once[r] = result[r];
+  }
+
+  // Offsets of the first overlap in each line (padded to 24 lines with line 0).
+  static constexpr std::array<int,24> line_starts = {
+    0, 3, 6, 9, 12, 15, 18, 21, 24, 27, 30, 33, 36, 39, 42, 45, 48, 51, 0, 0, 0, 0, 0, 0
+  };
+
+  __attribute__((target("avx2")))
+  inline void FindOverlapOnce_AVX2(const uint32_t * options, uint32_t * overlap_options,
+                                   uint32_t * line_once, uint32_t * box_once) {
+    alignas(32) uint32_t ov[56];
+    for (int i = 0; i < 56; i += 8) {
+      const __m256i v = _mm256_or_si256(_mm256_or_si256(Gather8_AVX2(options, &overlap_cells[0][i]),
+                                                        Gather8_AVX2(options, &overlap_cells[1][i])),
+                                        Gather8_AVX2(options, &overlap_cells[2][i]));
+      _mm256_store_si256((__m256i *) &ov[i], v);
+    }
+    for (int i = 0; i < NUM_OVERLAPS; i++) overlap_options[i] = ov[i];
+
+    alignas(32) uint32_t result[24];
+    for (int l = 0; l < 24; l += 8) {
+      const __m256i a = Gather8_AVX2(ov,     &line_starts[l]);
+      const __m256i b = Gather8_AVX2(ov + 1, &line_starts[l]);
+      const __m256i c = Gather8_AVX2(ov + 2, &line_starts[l]);
+      const __m256i odd = _mm256_xor_si256(_mm256_xor_si256(a, b), c);
+      const __m256i all = _mm256_and_si256(_mm256_and_si256(a, b), c);
+      _mm256_store_si256((__m256i *) &result[l], _mm256_andnot_si256(all, odd));
+    }
+    for (int l = 0; l < NUM_LINES; l++) line_once[l] = result[l];
+
+    for (int g = 0; g < 24; g += 8) {
+      const __m256i a = Gather8_AVX2(ov, &box_group_overlaps[0][g]);
+      const __m256i b = Gather8_AVX2(ov, &box_group_overlaps[1][g]);
+      const __m256i c = Gather8_AVX2(ov, &box_group_overlaps[2][g]);
+      const __m256i odd = _mm256_xor_si256(_mm256_xor_si256(a, b), c);
+      const __m256i all = _mm256_and_si256(_mm256_and_si256(a, b), c);
+      _mm256_store_si256((__m256i *) &result[g], _mm256_andnot_si256(all, odd));
+    }
+    for (int g = 0; g < NUM_BOX_GROUPS; g++) box_once[g] = result[g];
+  }
+
+#endif
+
+  // --- Runtime dispatch ---
+
+  using region_fun_t = void (*)(const uint32_t *, uint32_t *);
+  using overlap_fun_t = void (*)(const uint32_t *, uint32_t *, uint32_t *, uint32_t *);
+  using positions_fun_t = void (*)(const uint32_t *, uint32_t *);
+
+  struct Kernels {
+    Level level = Level::SCALAR;
+    region_fun_t find_region_once = FindRegionOnce_Scalar;
+    overlap_fun_t find_overlap_once = FindOverlapOnce_Scalar;
+    positions_fun_t find_state_positions = FindStatePositions_Scalar;
+  };
+
+  // What is the best level supported by this CPU?
+  inline Level GetBestLevel() {
+#ifdef PZE_SIMD_X86
+    if (__builtin_cpu_supports("avx2")) return Level::AVX2;
+    if (__builtin_cpu_supports("sse4.1")) return Level::SSE4;
+#endif
+    return Level::SCALAR;
+  }
+
+  inline Kernels BuildKernels(Level level) {
+    Kernels kernels;
+    if (level > GetBestLevel()) level = GetBestLevel();
+#ifdef PZE_SIMD_X86
+    if (level == Level::AVX2) {
+      kernels.find_region_once = FindRegionOnce_AVX2;
+      kernels.find_overlap_once = FindOverlapOnce_AVX2;
+    } else if (level == Level::SSE4) {
+      kernels.find_region_once = FindRegionOnce_SSE4;
+      kernels.find_overlap_once = FindOverlapOnce_SSE4;
+    } else level = Level::SCALAR;
+#else
+    level = Level::SCALAR;
+#endif
+    kernels.level = level;
+    return kernels;
+  }
+
+  inline Kernels & GetKernels() {
+    static Kernels kernels = BuildKernels(GetBestLevel());
+    return kernels;
+  }
+
+  inline Level GetLevel() { return GetKernels().level; }
+
+  // Force a specific kernel level (clamped to what the CPU supports); return the level used.
+  // This is not thread-safe and should only be called before solving begins.
+  inline Level SetLevel(Level level) {
+    GetKernels() = BuildKernels(level);
+    return GetKernels().level;
+  }
+
+  inline const char * GetLevelName(Level level) {
+    switch (level) {
+    case Level::AVX2: return "avx2";
+    case Level::SSE4: return "sse4";
+    default: return "scalar";
+    }
+  }
+
+  // For each of the 27 regions, which states are available in exactly one cell?
+  inline void FindRegionOnce(const uint32_t * options, uint32_t * opt_once) {
+    GetKernels().find_region_once(options, opt_once);
+  }
+
+  // Options available in each of the 54 overlaps; for each of the 18 rows/columns, the
+  // states available in only one of its three overlaps; and for each of the 18 box groups
+  // (see box_group_overlaps), the states available in only one of its three overlaps.
+  inline void FindOverlapOnce(const uint32_t * options, uint32_t * overlap_options,
+                              uint32_t * line_once, uint32_t * box_once) {
+    GetKernels().find_overlap_once(options, overlap_options, line_once, box_once);
+  }
+
+  // For each state s and region r, positions[s*27+r] has bit p set if s is an option in
+  // the cell at position p of the region.  (For rows, p is the column; for columns, the row.)
+  inline void FindStatePositions(const uint32_t * options, uint32_t * positions) {
+    GetKernels().find_state_positions(options, positions);
+  }
+
+}
+}
+
+#endif
@@ -0,0 +1,190 @@
+//  This file is part of PuzzleEngine, https://github.com/mercere99/PuzzleEngine/
+//  Copyright (C) Michigan State University, 2015.
+//  Released under the MIT Software license; see doc/LICENSE
+//
+//
+//  A small work-stealing thread pool.
+//
+//  Each thread owns a queue of tasks; it takes work from the back of its own queue
+//  and, when that runs dry, steals from the front of the other queues.  The thread
+//  that calls Wait() or ParallelFor() takes part in the work as queue zero, so a pool
+//  with N threads only starts N-1 workers.  A pool with a single thread (and every
+//  pool in an Emscripten build) runs all tasks inline on the calling thread.
+//
+//  Tasks must not submit further tasks to the same pool.
+
+#ifndef PZE_THREAD_POOL_H
+#define PZE_THREAD_POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace pze {
+
+  class ThreadPool {
+  public:
+    using task_t = std::function<void()>;
+
+  private:
+    // Keep each queue on its own cache line so owners and thieves don't false-share.
+    struct alignas(64) WorkQueue {
+      std::mutex mutex;
+      std::deque<task_t> tasks;
+    };
+
+    size_t num_threads;                     // Worker threads plus the calling thread.
+    std::unique_ptr<WorkQueue[]> queues;    // One per thread; queue 0 belongs to the caller.
+    std::vector<std::thread> workers;
+    size_t next_queue;                      // Where to place the next submitted task.
+
+    std::atomic<size_t> queued;             // Tasks waiting in a queue (changed under its lock).
+    std::atomic<size_t> pending;            // Tasks submitted but not yet finished.
+    bool stopping;
+
+    std::mutex wake_mutex;
+    std::condition_variable wake_cv;        // Signalled when tasks are queued (or on shutdown).
+    std::condition_variable done_cv;        // Signalled when the last pending task finishes.
+
+    // Tasks are counted out of queued while the queue is still locked, so queued never
+    // reports a task that is no longer in any queue.
+    bool PopTask(size_t queue_id, task_t & task) {
+      WorkQueue & queue = queues[queue_id];
+      std::lock_guard<std::mutex> lock(queue.mutex);
+      if (queue.tasks.empty()) return false;
+      task = std::move(queue.tasks.back());
+      queue.tasks.pop_back();
+      queued.fetch_sub(1, std::memory_order_acq_rel);
+      return true;
+    }
+
+    // Take a task from the front of another thread's queue.  Unless block is set, give up
+    // if its owner (or another thief) holds the lock.
+    bool StealTask(size_t queue_id, task_t & task, bool block) {
+      WorkQueue & queue = queues[queue_id];
+      std::unique_lock<std::mutex> lock(queue.mutex, std::defer_lock);
+      if (block) lock.lock();
+      else if (!lock.try_lock()) return false;
+      if (queue.tasks.empty()) return false;
+      task = std::move(queue.tasks.front());
+      queue.tasks.pop_front();
+      queued.fetch_sub(1, std::memory_order_acq_rel);
+      return true;
+    }
+
+    // Find a task for a thread: its own queue first, then every other queue in turn.  If
+    // tasks are still queued after a pass of quick steals, go around again waiting for each
+    // lock, so a thread only gives up (and sleeps) once the queues really are empty.
+    bool FindTask(size_t thread_id, task_t & task) {
+      if (queued.load(std::memory_order_acquire) == 0) return false;
+      if (PopTask(thread_id, task)) return true;
+      for (int pass = 0; pass < 2; pass++) {
+        if (pass == 1 && queued.load(std::memory_order_acquire) == 0) return false;
+        for (size_t i = 1; i < num_threads; i++) {
+          if (StealTask((thread_id + i) % num_threads, task, pass == 1)) return true;
+        }
+      }
+      return false;
+    }
+
+    void RunTask(task_t & task) {
+      task();
+      if (pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        std::lock_guard<std::mutex> lock(wake_mutex);
+        done_cv.notify_all();
+      }
+    }
+
+    void WorkerLoop(size_t thread_id) {
+      task_t task;
+      while (true) {
+        if (FindTask(thread_id, task)) { RunTask(task); continue; }
+        std::unique_lock<std::mutex> lock(wake_mutex);
+        wake_cv.wait(lock, [this]{ return stopping || queued.load(std::memory_order_acquire) > 0; });
+        if (stopping) return;
+      }
+    }
+
+  public:
+    // By default use every hardware thread available.
+    ThreadPool(size_t _threads=std::thread::hardware_concurrency())
+      : num_threads(std::max<size_t>(_threads, 1)), next_queue(0), queued(0), pending(0), stopping(false)
+    {
+#ifdef __EMSCRIPTEN__
+      num_threads = 1;
+#endif
+      queues = std::make_unique<WorkQueue[]>(num_threads);
+      for (size_t i = 1; i < num_threads; i++) workers.emplace_back([this, i]{ WorkerLoop(i); });
+    }
+    ThreadPool(const ThreadPool &) = delete;
+    ~ThreadPool() {
+      {
+        std::lock_guard<std::mutex> lock(wake_mutex);
+        stopping = true;
+      }
+      wake_cv.notify_all();
+      for (auto & worker : workers) worker.join();
+    }
+    ThreadPool & operator=(const ThreadPool &) = delete;
+
+    size_t GetNumThreads() const { return num_threads; }
+
+    // Queue up a task; it will run no later than the next call to Wait().
+    void Submit(task_t task) {
+      if (num_threads == 1) { task(); return; }
+
+      const size_t queue_id = next_queue;
+      next_queue = (next_queue + 1) % num_threads;
+      pending.fetch_add(1, std::memory_order_relaxed);
+      {
+        std::lock_guard<std::mutex> lock(queues[queue_id].mutex);
+        queues[queue_id].tasks.push_back(std::move(task));
+        queued.fetch_add(1, std::memory_order_release);
+      }
+      // Pass through wake_mutex so a worker that just saw no tasks is already waiting
+      // (and gets this notification) rather than about to wait.
+      { std::lock_guard<std::mutex> lock(wake_mutex); }
+      wake_cv.notify_one();
+    }
+
+    // Help run tasks until all submitted tasks have finished.
+    void Wait() {
+      task_t task;
+      while (pending.load(std::memory_order_acquire) > 0) {
+        if (FindTask(0, task)) { RunTask(task); continue; }
+        std::unique_lock<std::mutex> lock(wake_mutex);
+        done_cv.wait(lock, [this]{
+            return pending.load(std::memory_order_acquire) == 0
+              || queued.load(std::memory_order_acquire) > 0;
+          });
+      }
+    }
+
+    // Call fun(i) for every i in [0, count), split into chunks spread over all threads.
+    // Several chunks go to each thread so that stealing can even out uneven work.
+    template <typename FUN_T>
+    void ParallelFor(size_t count, FUN_T && fun, size_t chunks_per_thread=8) {
+      if (num_threads == 1 || count <= 1) {
+        for (size_t i = 0; i < count; i++) fun(i);
+        return;
+      }
+
+      const size_t num_chunks = std::min(count, num_threads * chunks_per_thread);
+      for (size_t chunk = 0; chunk < num_chunks; chunk++) {
+        const size_t start = count * chunk / num_chunks;
+        const size_t end = count * (chunk + 1) / num_chunks;
+        Submit([&fun, start, end]{ for (size_t i = start; i < end; i++) fun(i); });
+      }
+      Wait();
+    }
+  };
+
+}
+
+#endif
@@ -0,0 +1,564 @@
+//  This file is part of PuzzleEngine, https://github.com/mercere99/PuzzleEngine/
+//  Copyright (C) Michigan State University, 2015.
+//  Released under the MIT Software license; see doc/LICENSE
+//
+//  Benchmarks for the core solving routines of PuzzleEngine.
+//
+//  Every result is one CSV line, "benchmark, ns_per_op", and the fastest of several
+//  trials is kept to damp noise.  Usage:
+//    PuzzleBench [--out results.csv] [--baseline baseline.csv] [--threshold 0.10]
+//  With --baseline, each result is compared against the saved run and any benchmark that
+//  got slower by more than the threshold is flagged (and the exit status is 1).
+//  Run from the top directory, so that the puzzles/ corpus can be found.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "../Lexicase.h"
+#include "../LocalSearch.h"
+#include "../Population.h"
+#include "../Sudoku.h"
+#include "../SudokuBatch.h"
+#include "../SudokuCanon.h"
+#include "../SudokuCorpus.h"
+#include "../SudokuParse.h"
+#include "../SudokuPlanes.h"
+#include "../ThreadPool.h"
+
+// Time a function, returning the average number of nanoseconds per call.
+template <typename FUN_T>
+double TimeNS(int reps, FUN_T && fun) {
+  const auto start_time = std::chrono::steady_clock::now();
+  for (int i = 0; i < reps; i++) fun();
+  const auto end_time = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(end_time - start_time).count() / reps;
+}
+
+// Results of this run, in the order they were measured.
+std::vector<std::pair<std::string, double>> results;
+
+void Record(const std::string & name, double ns_per_op) {
+  results.emplace_back(name, ns_per_op);
+  std::cout << name << ", " << ns_per_op << std::endl;
+}
+
+// Time fun() (which does ops operations) several times and record the fastest trial.
+template <typename FUN_T>
+void Measure(const std::string & name, size_t ops, FUN_T && fun, int trials=3) {
+  double best_ns = TimeNS(1, fun);
+  for (int t = 1; t < trials; t++) best_ns = std::min(best_ns, TimeNS(1, fun));
+  Record(name, best_ns / ops);
+}
+
+// Run the singles-only solving ladder used by Sudoku::CalcProfile() on any state type.
+template <typename STATE_T>
+int RunSingles(STATE_T & state) {
+  int steps = 0;
+  while (true) {
+    auto moves = state.Solve_FindLastCellState(true);
+    if (moves.size() == 0) moves = state.Solve_FindLastRegionState(true);
+    if (moves.size() == 0) break;
+    state.Move(moves);
+    steps++;
+  }
+  return steps;
+}
+
+// Build a collection of random puzzles from the default solution grid.
+std::vector<pze::Sudoku> MakePuzzles(emp::Random & random, int count, double start_prob) {
+  std::vector<pze::Sudoku> puzzles;
+  for (int i = 0; i < count; i++) {
+    pze::Sudoku puz;
+    puz.Shuffle(random);
+    puz.RandomizeStart(random, start_prob);
+    puzzles.push_back(puz);
+  }
+  return puzzles;
+}
+
+// Compare the cell-major (SudokuState) and digit-major (SudokuPlaneState) layouts.
+template <typename STATE_T>
+void BenchLayout(const std::string & name, const std::vector<pze::Sudoku> & puzzles, int reps) {
+  std::vector<STATE_T> start_states;
+  for (const auto & puz : puzzles) start_states.emplace_back(puz.GetState());
+
+  // Set every cell of each solution grid, in order.
+  int checksum = 0;
+  Measure(name + "/Set", puzzles.size() * 81 * reps, [&](){
+      for (int r = 0; r < reps; r++) {
+        for (const auto & puz : puzzles) {
+          STATE_T state(&puz);
+          for (int cell = 0; cell < 81; cell++) state.Set(cell, puz.GetCell(cell));
+          checksum += state.GetValue(80);
+        }
+      }
+    });
+
+  // Run the singles ladder from each starting state.
+  Measure(name + "/Singles", puzzles.size() * reps, [&](){
+      for (int r = 0; r < reps; r++) {
+        for (const auto & start : start_states) {
+          STATE_T state(start);
+          checksum += RunSingles(state);
+        }
+      }
+    });
+  if (checksum == -1) std::cerr << "(checksum)" << std::endl;  // Keep the work observable.
+}
+
+// Compare the scalar and vectorized region-wide scans on every supported kernel level.
+void BenchSIMD(const std::vector<pze::Sudoku> & puzzles, int reps) {
+  std::vector<pze::Sudoku::SudokuState> start_states;
+  for (const auto & puz : puzzles) start_states.emplace_back(puz.GetState());
+
+  const pze::simd::Level best = pze::simd::GetBestLevel();
+  size_t checksum = 0;
+  for (int level = 0; level <= (int) best; level++) {
+    const std::string name = pze::simd::GetLevelName( pze::simd::SetLevel((pze::simd::Level) level) );
+    pze::MoveBuffer moves;
+    Measure("simd_" + name + "/RegionKernels", puzzles.size() * reps, [&](){
+        uint32_t opt_once[27], overlap_options[54], line_once[18], box_once[18], positions[243];
+        for (int r = 0; r < reps; r++) {
+          for (auto & state : start_states) {
+            const uint32_t * options = state.GetOptionsArray().data();
+            pze::simd::FindRegionOnce(options, opt_once);
+            pze::simd::FindOverlapOnce(options, overlap_options, line_once, box_once);
+            pze::simd::FindStatePositions(options, positions);
+            checksum += opt_once[0] + line_once[0] + box_once[0] + positions[0];
+          }
+        }
+      });
+    Measure("simd_" + name + "/FindLastRegionState", puzzles.size() * reps, [&](){
+        for (int r = 0; r < reps; r++) {
+          for (auto & state : start_states) {
+            moves.Clear();
+            state.Solve_FindLastRegionState(moves);
+            checksum += moves.GetSize();
+          }
+        }
+      });
+    Measure("simd_" + name + "/FindRegionOverlap", puzzles.size() * reps, [&](){
+        for (int r = 0; r < reps; r++) {
+          for (auto & state : start_states) {
+            moves.Clear();
+            state.Solve_FindRegionOverlap(moves);
+            checksum += moves.GetSize();
+          }
+        }
+      });
+  }
+  pze::simd::SetLevel(best);
+  if (checksum == 0) std::cerr << "(checksum)" << std::endl;  // Keep the work observable.
+}
+
+// List all of the puzzle files in a directory, in name order.
+std::vector<std::string> ListPuzzleFiles(const std::string & dir) {
+  std::vector<std::string> files;
+  if (!std::filesystem::is_directory(dir)) return files;
+  for (const auto & entry : std::filesystem::directory_iterator(dir)) {
+    if (entry.path().extension() == ".puz") files.push_back(entry.path().string());
+  }
+  std::sort(files.begin(), files.end());
+  return files;
+}
+
+// A puzzle file from the corpus, loaded.
+struct CorpusPuzzle {
+  std::string name;        // File name, without directory or extension.
+  std::string text;        // File contents.
+  pze::Sudoku puz;
+};
+
+std::vector<CorpusPuzzle> LoadCorpus(const std::vector<std::string> & files) {
+  std::vector<CorpusPuzzle> corpus;
+  for (const std::string & filename : files) {
+    std::ifstream in(filename);
+    std::stringstream text;
+    text << in.rdbuf();
+    corpus.push_back(CorpusPuzzle{std::filesystem::path(filename).stem().string(), text.str(),
+                                  pze::Sudoku(filename)});
+  }
+  return corpus;
+}
+
+// Compare the iterative MRV search against the original recursive cell-order search.
+// The recursive search can take seconds on the hard corpus, so it only runs once.
+void BenchForceSolve(const std::vector<CorpusPuzzle> & corpus, int reps) {
+  for (const CorpusPuzzle & entry : corpus) {
+    const auto & start = entry.puz.GetState();
+    bool solved = true;
+    Measure("ForceSolve/" + entry.name, reps, [&](){
+        for (int r = 0; r < reps; r++) {
+          auto state = start;
+          solved &= state.ForceSolve();
+        }
+      });
+    Measure("ForceSolve_Recursive/" + entry.name, 1, [&](){
+        auto state = start;
+        solved &= state.ForceSolve_Recursive();
+      }, 1);
+    if (!solved) std::cerr << entry.name << ": UNSOLVED" << std::endl;
+  }
+}
+
+// Time each solving technique on every corpus puzzle, both at its start and where the
+// singles ladder stalls (where the harder techniques have work to do).
+void BenchTechniques(const std::vector<CorpusPuzzle> & corpus, int reps) {
+  std::vector<pze::Sudoku::SudokuState> states;
+  for (const CorpusPuzzle & entry : corpus) {
+    auto state = entry.puz.GetState();
+    states.push_back(state);
+    RunSingles(state);
+    states.push_back(state);
+  }
+
+  size_t checksum = 0;
+  pze::MoveBuffer moves;
+  auto bench_technique = [&](const std::string & name, auto && find) {
+    Measure("Solve_" + name, states.size() * reps, [&](){
+        for (int r = 0; r < reps; r++) {
+          for (auto & state : states) {
+            moves.Clear();
+            find(state);
+            checksum += moves.GetSize();
+          }
+        }
+      });
+  };
+  bench_technique("FindLastCellState", [&](auto & state){ state.Solve_FindLastCellState(moves); });
+  bench_technique("FindLastRegionState", [&](auto & state){ state.Solve_FindLastRegionState(moves); });
+  bench_technique("FindRegionOverlap", [&](auto & state){ state.Solve_FindRegionOverlap(moves); });
+  bench_technique("FindLimitedCells", [&](auto & state){ state.Solve_FindLimitedCells(moves); });
+  bench_technique("FindLimitedStates", [&](auto & state){ state.Solve_FindLimitedStates(moves); });
+  for (int size = 2; size <= 4; size++) {
+    const std::string suffix = "(" + std::to_string(size) + ")";
+    bench_technique("FindNakedSubsets" + suffix, [&](auto & state){ state.Solve_FindNakedSubsets(moves, size); });
+    bench_technique("FindHiddenSubsets" + suffix, [&](auto & state){ state.Solve_FindHiddenSubsets(moves, size); });
+    bench_technique("FindFish" + suffix, [&](auto & state){ state.Solve_FindFish(moves, size); });
+  }
+  if (checksum == 0) std::cerr << "(checksum)" << std::endl;  // Keep the work observable.
+}
+
+// Time the whole-puzzle operations on the corpus: loading, shuffling, and profiling.
+void BenchCorpusPuzzles(const std::vector<CorpusPuzzle> & corpus, emp::Random & random, int reps) {
+  uint64_t checksum = 0;
+  Measure("Load", corpus.size() * reps, [&](){
+      for (int r = 0; r < reps; r++) {
+        for (const CorpusPuzzle & entry : corpus) {
+          std::stringstream in(entry.text);
+          checksum += pze::Sudoku(in).GetGridID();
+        }
+      }
+    });
+  std::vector<pze::Sudoku> puzzles;
+  for (const CorpusPuzzle & entry : corpus) puzzles.push_back(entry.puz);
+  Measure("Shuffle", puzzles.size() * reps, [&](){
+      for (int r = 0; r < reps; r++) {
+        for (auto & puz : puzzles) {
+          puz.Shuffle(random);
+          checksum += puz.GetGridID();
+        }
+      }
+    });
+  Measure("CalcProfile/corpus", corpus.size() * reps, [&](){
+      for (int r = 0; r < reps; r++) {
+        for (const CorpusPuzzle & entry : corpus) {
+          pze::Sudoku puz(entry.puz);       // A fresh copy, so nothing is cached.
+          checksum += puz.CalcProfile().GetSize();
+        }
+      }
+    });
+  if (checksum == 0) std::cerr << "(checksum)" << std::endl;  // Keep the work observable.
+}
+
+// Time one generation of the evolutionary search, as run by the command-line driver
+// (mutate, evaluate in batches, elite and tournament selection), on a single thread.
+void BenchGeneration(const pze::Sudoku & seed, emp::Random & random, int pop_size, int gens) {
+  pze::ThreadPool pool(1);
+  pze::Population<pze::Sudoku> pop;
+  pop.Insert(seed, pop_size);
+  auto fit_fun = [](pze::Sudoku * s){ return s->CalcSimpleFitness(); };
+  Measure("EA/Generation(pop=" + std::to_string(pop_size) + ")", gens, [&](){
+      for (int gen = 0; gen < gens; gen++) {
+        for (int i = 1; i < pop.GetSize(); i++) pop[i].MutateStart(random, 0.015);
+        pze::EvaluatePopulationBatched(pop, pool);
+        pop.EliteSelect(fit_fun, 1, 1);
+        pop.TournamentSelect(fit_fun, 4, random, pop_size - 1);
+        pop.Update();
+      }
+    }, 1);
+}
+
+// Time one step of tabu local search (all 81 single-toggle neighbors evaluated), on a
+// single thread.
+void BenchLocalSearch(const pze::Sudoku & seed, emp::Random & random, int steps) {
+  pze::ThreadPool pool(1);
+  pze::SudokuLocalSearch search(pool);
+  pze::SudokuLocalSearch::Config config;
+  config.max_steps = steps;
+  config.tabu_tenure = 7;
+  config.max_restarts = steps;
+  Measure("LocalSearch/Step", steps, [&](){ search.Run(seed, random, config); }, 1);
+}
+
+// Time uniqueness checks (CountSolutions with a limit of two) on random candidates.
+void BenchUniqueness(const std::vector<pze::Sudoku> & puzzles, int reps) {
+  int unique = 0;
+  Measure("CountSolutions(2)", puzzles.size() * reps, [&](){
+      for (int r = 0; r < reps; r++) {
+        for (const auto & puz : puzzles) unique += puz.HasUniqueSolution();
+      }
+    });
+  if (unique == -1) std::cerr << "(checksum)" << std::endl;  // Keep the work observable.
+}
+
+// Compare evaluating puzzles one at a time with CalcProfile() against lockstep batches.
+void BenchBatch(const std::string & name, const std::vector<pze::Sudoku> & puzzles, int reps) {
+  double checksum = 0.0;
+  Measure("CalcProfile/" + name, puzzles.size() * reps, [&](){
+      for (int r = 0; r < reps; r++) {
+        std::vector<pze::Sudoku> todo(puzzles);
+        for (auto & puz : todo) checksum += puz.CalcSimpleFitness();
+      }
+    }, 1);
+  Measure("SudokuBatch/" + name, puzzles.size() * reps, [&](){
+      for (int r = 0; r < reps; r++) {
+        std::vector<pze::Sudoku> todo(puzzles);
+        std::vector<pze::Sudoku*> ptrs;
+        for (auto & puz : todo) ptrs.push_back(&puz);
+        pze::SudokuBatch batch;
+        batch.Evaluate(ptrs.data(), ptrs.size());
+        for (auto & puz : todo) checksum -= puz.CalcSimpleFitness();
+      }
+    }, 1);
+  if (checksum != 0.0) std::cerr << "(batch profiles differ!)" << std::endl;
+}
+
+// Time generating random solution grids, and check how many of them are distinct.
+void BenchGridGen(emp::Random & random, int count) {
+  pze::Sudoku puz;
+  std::unordered_set<uint64_t> grid_ids;
+  Measure("RandomizeCells", count, [&](){
+      for (int i = 0; i < count; i++) {
+        puz.RandomizeCells(random);
+        grid_ids.insert(puz.GetGridID());
+      }
+    }, 1);
+  if (grid_ids.size() < (size_t) count) {
+    std::cerr << "RandomizeCells: only " << grid_ids.size() << " of " << count << " distinct" << std::endl;
+  }
+}
+
+// Time canonicalizing puzzles, and count how many are distinct up to symmetry.
+void BenchCanon(const std::vector<pze::Sudoku> & puzzles) {
+  pze::SudokuCanonicalizer canon;
+  pze::CanonicalHashSet seen;
+  Measure("Canonicalize", puzzles.size(), [&](){
+      for (const auto & puz : puzzles) seen.Insert(canon.Canonicalize(puz).GetHash());
+    });
+  if (seen.GetSize() == 0) std::cerr << "(checksum)" << std::endl;  // Keep the work observable.
+}
+
+// Compare loading puzzles from a binary corpus against parsing their text form.
+void BenchCorpus(const std::vector<pze::Sudoku> & puzzles) {
+  const std::string filename = (std::filesystem::temp_directory_path() / "pze_bench.pzc").string();
+  pze::CorpusWriter writer(filename);
+  std::stringstream text;
+  for (pze::Sudoku puz : puzzles) {
+    writer.Write(puz);
+    puz.Print(true, text);
+  }
+  writer.Close();
+
+  pze::CorpusReader reader(filename);
+  uint64_t checksum = 0;
+  Measure("CorpusLoad", puzzles.size(), [&](){
+      pze::Sudoku puz;
+      for (size_t i = 0; i < reader.GetSize(); i++) {
+        reader[i].CopyTo(puz);
+        checksum += puz.GetGridID();
+      }
+    });
+  Measure("TextLoad", puzzles.size(), [&](){
+      text.clear();
+      text.seekg(0);
+      for (size_t i = 0; i < puzzles.size(); i++) checksum += pze::Sudoku(text).GetGridID();
+    });
+  reader.Close();
+  std::filesystem::remove(filename);
+  if (checksum == 0) std::cerr << "(checksum)" << std::endl;  // Keep the work observable.
+}
+
+// Load puzzles from one-line text: through a stream (Load) and in bulk, with and without
+// filling in the blank cells.
+void BenchParse(const std::vector<pze::Sudoku> & puzzles) {
+  std::string text;
+  for (const auto & puz : puzzles) {
+    for (int i = 0; i < 81; i++) text += puz.GetStart(i) ? (char) ('1' + puz.GetCell(i)) : '.';
+    text += '\n';
+  }
+  std::string dashed = text;
+  std::replace(dashed.begin(), dashed.end(), '.', '-');
+
+  uint64_t checksum = 0;
+  Measure("StreamLoad", puzzles.size(), [&](){
+      std::stringstream in(dashed);
+      for (size_t i = 0; i < puzzles.size(); i++) checksum += pze::Sudoku(in).GetGridID();
+    });
+  Measure("BulkParse", puzzles.size(), [&](){
+      std::vector<pze::Sudoku> loaded;
+      loaded.reserve(puzzles.size());
+      checksum += pze::ParsePuzzles(text, loaded, false);
+    });
+  Measure("BulkParseSolve", puzzles.size(), [&](){
+      std::vector<pze::Sudoku> loaded;
+      loaded.reserve(puzzles.size());
+      checksum += pze::ParsePuzzles(text, loaded, true);
+    });
+  if (checksum == 0) std::cerr << "(checksum)" << std::endl;  // Keep the work observable.
+}
+
+// Time a generation's worth of lexicase selections over the profile objectives, including
+// building the objective matrix and preparing the selector.
+void BenchLexicase(const std::vector<pze::Sudoku> & puzzles, emp::Random & random) {
+  pze::Population<pze::Sudoku> pop;
+  for (const auto & puz : puzzles) pop.Insert(puz);
+  for (int i = 0; i < pop.GetSize(); i++) pop[i].CalcProfile();
+
+  size_t checksum = 0;
+  pze::LexicaseSelector selector;
+  for (auto mode : { pze::LexicaseSelector::Epsilon::NONE, pze::LexicaseSelector::Epsilon::MAD }) {
+    const std::string name = (mode == pze::LexicaseSelector::Epsilon::NONE) ? "Lexicase" : "EpsilonLexicase";
+    Measure(name + "/Generation", 1, [&](){
+        const pze::ObjectiveMatrix objectives = pze::BuildProfileObjectives(pop);
+        selector.Setup(objectives, mode);
+        for (int i = 0; i < pop.GetSize(); i++) checksum += selector.Select(random);
+      });
+  }
+  if (checksum == 0) std::cerr << "(checksum)" << std::endl;  // Keep the work observable.
+}
+
+// Show where the time goes in the CalcProfile() ladder, rung by rung.
+template <typename LADDER>
+void BenchLadder(const std::string & name, const std::vector<pze::Sudoku> & puzzles) {
+  typename LADDER::Stats stats;
+  for (const auto & puz : puzzles) {
+    auto state = puz.GetState();
+    pze::PuzzleProfile profile;
+    pze::Sudoku::RunProfile<LADDER>(state, profile, &stats);
+  }
+  for (int i = 0; i < LADDER::NUM_RUNGS; i++) {
+    const pze::TechniqueStats & rung = stats.rungs[i];
+    Record("Ladder_" + name + "/" + LADDER::names[i], rung.calls ? (double) rung.ns / rung.calls : 0.0);
+  }
+}
+
+// Load a results file written by an earlier run.
+std::map<std::string, double> LoadResults(const std::string & filename) {
+  std::map<std::string, double> loaded;
+  std::ifstream in(filename);
+  std::string line;
+  while (std::getline(in, line)) {
+    const size_t comma = line.rfind(',');
+    if (comma == std::string::npos || line == "benchmark, ns_per_op") continue;
+    loaded[line.substr(0, comma)] = std::atof(line.c_str() + comma + 1);
+  }
+  return loaded;
+}
+
+// Compare this run against a baseline; return the number of benchmarks that got slower
+// by more than the threshold (a fraction).
+int CompareResults(const std::map<std::string, double> & baseline, double threshold) {
+  int regressions = 0;
+  std::cout << std::endl << "benchmark, baseline_ns, current_ns, ratio, status" << std::endl;
+  for (const auto & [name, current] : results) {
+    auto it = baseline.find(name);
+    if (it == baseline.end()) {
+      std::cout << name << ", , " << current << ", , new" << std::endl;
+      continue;
+    }
+    const double ratio = (it->second > 0.0) ? current / it->second : 1.0;
+    const char * status = "ok";
+    if (ratio > 1.0 + threshold) { status = "SLOWER"; regressions++; }
+    else if (ratio < 1.0 - threshold) status = "faster";
+    std::cout << name << ", " << it->second << ", " << current << ", " << ratio << ", " << status << std::endl;
+  }
+  std::cerr << regressions << " of " << results.size() << " benchmarks slower than the baseline by more than "
+            << (threshold * 100.0) << "%." << std::endl;
+  return regressions;
+}
+
+int main(int argc, char * argv[])
+{
+  std::string out_name;
+  std::string baseline_name;
+  double threshold = 0.10;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    const std::string arg = argv[i];
+    if (arg == "--out") out_name = argv[i+1];
+    else if (arg == "--baseline") baseline_name = argv[i+1];
+    else if (arg == "--threshold") threshold = std::atof(argv[i+1]);
+    else {
+      std::cerr << "Usage: " << argv[0] << " [--out results.csv] [--baseline baseline.csv] [--threshold 0.10]" << std::endl;
+      return 2;
+    }
+  }
+
+  emp::Random random(1);
+  const int reps = 20;
+  const auto puzzles = MakePuzzles(random, 1000, 0.35);
+
+  std::vector<std::string> files = ListPuzzleFiles("puzzles");
+  std::vector<std::string> hard_files = ListPuzzleFiles("puzzles/hard");
+  files.insert(files.end(), hard_files.begin(), hard_files.end());
+  const auto corpus = LoadCorpus(files);
+  if (corpus.empty()) std::cerr << "No puzzles/ corpus found; run from the top directory." << std::endl;
+
+  std::cout << "benchmark, ns_per_op" << std::endl;
+  BenchLayout<pze::Sudoku::SudokuState>("cell_major", puzzles, reps);
+  BenchLayout<pze::SudokuPlaneState>("digit_planes", puzzles, reps);
+  BenchSIMD(puzzles, reps);
+  BenchUniqueness(puzzles, 5);
+  BenchBatch("sparse", puzzles, 5);
+  BenchBatch("dense", MakePuzzles(random, 1000, 0.6), 5);
+  BenchGridGen(random, 10000);
+  BenchCanon(puzzles);
+  BenchCorpus(puzzles);
+  BenchParse(puzzles);
+  BenchLexicase(puzzles, random);
+  BenchLadder<pze::Sudoku::DefaultLadder>("default", puzzles);
+  BenchLadder<pze::Sudoku::SinglesLadder>("singles", puzzles);
+  if (!corpus.empty()) {
+    BenchTechniques(corpus, 200);
+    BenchCorpusPuzzles(corpus, random, 50);
+    BenchForceSolve(corpus, 100);
+    const auto seed = std::find_if(corpus.begin(), corpus.end(),
+                                   [](const CorpusPuzzle & entry){ return entry.name == "wikipedia"; });
+    const pze::Sudoku & seed_puz = (seed != corpus.end() ? *seed : corpus.front()).puz;
+    BenchGeneration(seed_puz, random, 200, 10);
+    BenchLocalSearch(seed_puz, random, 20);
+  }
+
+  if (!out_name.empty()) {
+    std::ofstream out(out_name);
+    out << "benchmark, ns_per_op" << std::endl;
+    for (const auto & [name, ns] : results) out << name << ", " << ns << std::endl;
+  }
+  if (!baseline_name.empty()) {
+    const auto baseline = LoadResults(baseline_name);
+    if (baseline.empty()) {
+      std::cerr << "Unable to read baseline '" << baseline_name << "'." << std::endl;
+      return 2;
+    }
+    if (CompareResults(baseline, threshold) > 0) return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,501 @@
+//  This file is part of PuzzleEngine, https://github.com/mercere99/PuzzleEngine/
+//  Copyright (C) Michigan State University, 2015.
+//  Released under the MIT Software license; see doc/LICENSE
+//
+//  Consistency checks for PuzzleEngine's fast paths: each one is compared against a
+//  simpler (or scalar) version of the same calculation on randomly generated puzzles,
+//  and a few invariants (such as elitism across migrations) are checked directly.
+//  Prints one line per check and exits with status 1 if any check fails.  Run with
+//  "make check".
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <set>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../IslandModel.h"
+#include "../Lexicase.h"
+#include "../LocalSearch.h"
+#include "../Sudoku.h"
+#include "../SudokuBatch.h"
+#include "../SudokuCanon.h"
+#include "../SudokuCorpus.h"
+#include "../SudokuParse.h"
+#include "../SudokuPlanes.h"
+#include "../SudokuSIMD.h"
+
+int num_failed = 0;
+
+// Report the result of a check that found num_bad mismatches in num_tried cases.
+void Report(const std::string & name, size_t num_bad, size_t num_tried) {
+  std::cout << name << ": " << (num_bad ? "FAILED" : "ok")
+            << " (" << num_bad << " of " << num_tried << " mismatched)" << std::endl;
+  if (num_bad) num_failed++;
+}
+
+// A random puzzle on a random grid, with about start_prob of the cells given.
+pze::Sudoku RandomPuzzle(emp::Random & random, double start_prob) {
+  pze::Sudoku puz;
+  puz.Shuffle(random);
+  puz.RandomizeStart(random, start_prob);
+  return puz;
+}
+
+bool SameMoves(const std::vector<pze::PuzzleMove> & a, const std::vector<pze::PuzzleMove> & b) {
+  if (a.size() != b.size()) return false;
+  for (size_t i = 0; i < a.size(); i++) {
+    if (a[i].GetType() != b[i].GetType() || a[i].GetID() != b[i].GetID()
+        || a[i].GetState() != b[i].GetState()) return false;
+  }
+  return true;
+}
+
+bool SameProfile(const pze::PuzzleProfile & a, const pze::PuzzleProfile & b) {
+  if (a.GetSize() != b.GetSize() || a.IsSolved() != b.IsSolved()
+      || a.GetSolutionCount() != b.GetSolutionCount()) return false;
+  for (int i = 0; i < a.GetSize(); i++) {
+    if (a.GetLevel(i) != b.GetLevel(i) || a.GetCount(i) != b.GetCount(i)) return false;
+  }
+  return true;
+}
+
+// Singles scans limited to dirty cells and regions must find the same moves as full scans.
+void CheckDirtyScans(emp::Random & random) {
+  size_t num_bad = 0, num_tried = 0;
+  for (int t = 0; t < 1000; t++) {
+    pze::Sudoku puz = RandomPuzzle(random, 0.2 + 0.3 * random.GetDouble());
+    auto state = puz.GetState();
+    while (true) {
+      auto full = state.Solve_FindLastCellState();
+      num_bad += !SameMoves(full, state.Solve_FindLastCellState(true));
+      num_tried++;
+      if (full.size()) { state.Move(full); continue; }
+      full = state.Solve_FindLastRegionState();
+      num_bad += !SameMoves(full, state.Solve_FindLastRegionState(true));
+      num_tried++;
+      if (full.size()) { state.Move(full); continue; }
+      break;
+    }
+  }
+  Report("dirty singles scans match full scans", num_bad, num_tried);
+}
+
+// SudokuPlaneState must find the same singles as SudokuState, with and without dirty-only
+// scans.
+void CheckPlaneState(emp::Random & random) {
+  size_t num_bad = 0, num_tried = 0;
+  for (int t = 0; t < 1000; t++) {
+    pze::Sudoku puz = RandomPuzzle(random, 0.2 + 0.3 * random.GetDouble());
+    auto state = puz.GetState();
+    pze::SudokuPlaneState planes(state);
+    while (true) {
+      auto moves = state.Solve_FindLastCellState();
+      num_bad += !SameMoves(moves, planes.Solve_FindLastCellState());
+      num_bad += !SameMoves(moves, planes.Solve_FindLastCellState(true));
+      num_tried++;
+      if (moves.empty()) {
+        moves = state.Solve_FindLastRegionState();
+        num_bad += !SameMoves(moves, planes.Solve_FindLastRegionState());
+        num_bad += !SameMoves(moves, planes.Solve_FindLastRegionState(true));
+        num_tried++;
+      }
+      if (moves.empty()) break;
+      state.Move(moves);
+      planes.Move(moves);
+    }
+  }
+  Report("digit-plane singles scans match SudokuState", num_bad, num_tried);
+}
+
+// Line/box reductions found directly: if a state's options along a row or column all fall
+// in one box, every other cell of that box loses the state (claiming); if a state's options
+// in a box all fall in one row or column, every other cell of that line loses the state
+// (pointing).  Returns (cell, state) pairs.
+std::set<std::pair<int,int>> DirectOverlapBlocks(pze::Sudoku::SudokuState & state) {
+  std::set<std::pair<int,int>> blocks;
+  for (int line = 0; line < 18; line++) {
+    for (int s = 0; s < 9; s++) {
+      std::set<int> boxes;
+      for (int pos = 0; pos < 9; pos++) {
+        const int cell = (line < 9) ? line*9 + pos : pos*9 + (line - 9);
+        if (state.HasOption(cell, s)) boxes.insert((cell / 27) * 3 + (cell % 9) / 3);
+      }
+      if (boxes.size() != 1) continue;
+      const int box = *boxes.begin();
+      for (int i = 0; i < 9; i++) {
+        const int cell = (box / 3) * 27 + (box % 3) * 3 + (i / 3) * 9 + i % 3;
+        const bool on_line = (line < 9) ? (cell / 9 == line) : (cell % 9 == line - 9);
+        if (!on_line && state.HasOption(cell, s)) blocks.emplace(cell, s);
+      }
+    }
+  }
+  for (int box = 0; box < 9; box++) {
+    for (int s = 0; s < 9; s++) {
+      std::set<int> rows, cols;
+      for (int i = 0; i < 9; i++) {
+        const int cell = (box / 3) * 27 + (box % 3) * 3 + (i / 3) * 9 + i % 3;
+        if (state.HasOption(cell, s)) { rows.insert(cell / 9); cols.insert(cell % 9); }
+      }
+      if (rows.size() != 1 && cols.size() != 1) continue;
+      for (int cell = 0; cell < 81; cell++) {
+        const bool on_line = (rows.size() == 1 && cell / 9 == *rows.begin())
+          || (cols.size() == 1 && cell % 9 == *cols.begin());
+        const bool in_box = (cell / 27) * 3 + (cell % 9) / 3 == box;
+        if (on_line && !in_box && state.HasOption(cell, s)) blocks.emplace(cell, s);
+      }
+    }
+  }
+  return blocks;
+}
+
+// Solve_FindRegionOverlap() must find exactly the direct line/box reductions, each once,
+// at every SIMD level, and never remove a cell's solution value.
+void CheckRegionOverlap(emp::Random & random) {
+  using pze::simd::Level;
+  const Level start_level = pze::simd::GetLevel();
+  size_t num_bad = 0, num_tried = 0;
+  for (int t = 0; t < 500; t++) {
+    pze::Sudoku puz = RandomPuzzle(random, 0.15 + 0.25 * random.GetDouble());
+    auto state = puz.GetState();
+    const auto expected = DirectOverlapBlocks(state);
+    for (Level level : { Level::SCALAR, Level::SSE4, Level::AVX2 }) {
+      pze::simd::SetLevel(level);
+      std::set<std::pair<int,int>> found;
+      bool valid = true;
+      const auto moves = state.Solve_FindRegionOverlap();
+      for (const auto & move : moves) {
+        found.emplace(move.GetID(), move.GetState());
+        valid &= move.GetType() == pze::PuzzleMove::BLOCK_STATE && puz.GetCell(move.GetID()) != move.GetState();
+      }
+      num_bad += !valid || found != expected || found.size() != moves.size();
+      num_tried++;
+    }
+  }
+  pze::simd::SetLevel(start_level);
+  Report("region overlaps match direct line/box reductions", num_bad, num_tried);
+}
+
+// Start cells alone (no solution grid) that are usually unsolvable: either a real puzzle
+// with a few givens changed, or givens scattered at random.  Givens may repeat a peer's.
+pze::Sudoku RandomStartOnly(emp::Random & random) {
+  std::array<int,81> states;
+  if (random.P(0.5)) {
+    const pze::Sudoku puz = RandomPuzzle(random, 0.2 + 0.4 * random.GetDouble());
+    for (int c = 0; c < 81; c++) states[c] = puz.GetStart(c) ? puz.GetCell(c) : -1;
+    for (int i = (int) random.GetUInt(1, 4); i > 0; i--) states[random.GetUInt(81)] = (int) random.GetUInt(9);
+  } else {
+    const double start_prob = 0.1 + 0.3 * random.GetDouble();
+    for (int c = 0; c < 81; c++) states[c] = random.P(start_prob) ? (int) random.GetUInt(9) : -1;
+  }
+  pze::Sudoku puz;
+  puz.SetStartCells(states, false);
+  return puz;
+}
+
+// The singles ladder must give the same profile (and stop on the same contradictions) on
+// digit planes as on SudokuState, for contradictory starts too.
+void CheckPlaneLadder(emp::Random & random) {
+  size_t num_bad = 0, num_tried = 0;
+  for (int t = 0; t < 2000; t++) {
+    const pze::Sudoku puz = (t % 2) ? RandomStartOnly(random) : RandomPuzzle(random, 0.2 + 0.3 * random.GetDouble());
+    auto state = puz.GetState();
+    pze::SudokuPlaneState planes(&puz);
+    for (int c = 0; c < 81; c++) if (puz.GetStart(c)) planes.Set(c, puz.GetCell(c));
+    num_bad += planes.HasContradiction() != state.HasContradiction();
+    pze::PuzzleProfile profile, plane_profile;
+    const bool ok = pze::Sudoku::SinglesLadder::Run(state, profile);
+    const bool plane_ok = pze::SudokuPlaneState::SinglesLadder::Run(planes, plane_profile);
+    num_bad += ok != plane_ok || !SameProfile(profile, plane_profile);
+    num_tried++;
+  }
+  Report("digit-plane singles ladder matches SudokuState", num_bad, num_tried);
+}
+
+// SudokuBatch must produce the same profiles (and fitness) as the scalar CalcProfile(),
+// including for puzzles that are unsolvable or contradictory from the start.
+void CheckBatchProfiles(emp::Random & random) {
+  std::vector<pze::Sudoku> scalar, batched;
+  for (int i = 0; i < 6000; i++) {
+    if (i % 2) scalar.push_back(RandomStartOnly(random));
+    else scalar.push_back(RandomPuzzle(random, 0.2 + 0.4 * random.GetDouble()));
+    batched.push_back(scalar.back());
+  }
+  std::vector<pze::Sudoku *> todo;
+  for (auto & puz : batched) todo.push_back(&puz);
+  pze::SudokuBatch batch;
+  batch.Evaluate(todo.data(), todo.size());
+
+  size_t num_bad = 0;
+  for (size_t i = 0; i < scalar.size(); i++) {
+    const bool same = batched[i].IsEvaluated()
+      && SameProfile(scalar[i].CalcProfile(), batched[i].GetProfile())
+      && scalar[i].CalcSimpleFitness() == batched[i].GetFitness();
+    num_bad += !same;
+  }
+  Report("batch profiles match scalar profiles", num_bad, scalar.size());
+}
+
+// Batch mode grades lines parsed without solving, through SudokuBatch; every line must
+// grade as CalcProfile() does on the same line parsed alone, unsolvable ones included.
+// (Not loaded with Load(), which relabels symbols: in a contradictory state, which of two
+// hidden singles in a cell is taken depends on the labels.)
+void CheckBatchGrading(emp::Random & random) {
+  std::string text;
+  for (int i = 0; i < 1000; i++) {
+    const pze::Sudoku puz = (i % 2) ? RandomStartOnly(random) : RandomPuzzle(random, 0.3);
+    for (int c = 0; c < 81; c++) text += puz.GetStart(c) ? (char) ('1' + puz.GetCell(c)) : '-';
+    text += '\n';
+  }
+  std::vector<pze::Sudoku> graded;
+  pze::ParsePuzzles(text, graded, false);
+  std::vector<pze::Sudoku *> todo;
+  for (auto & puz : graded) todo.push_back(&puz);
+  pze::SudokuBatch batch;
+  batch.Evaluate(todo.data(), todo.size());
+
+  size_t num_bad = (graded.size() != 1000);
+  std::stringstream lines(text);
+  for (size_t i = 0; i < graded.size(); i++) {
+    std::string line;
+    std::getline(lines, line);
+    std::vector<pze::Sudoku> alone;
+    pze::ParsePuzzles(line, alone, false);
+    num_bad += alone.size() != 1 || !SameProfile(alone[0].CalcProfile(), graded[i].GetProfile())
+      || alone[0].CalcSimpleFitness() != graded[i].GetFitness();
+  }
+  Report("batch grading matches CalcProfile() on each line", num_bad, graded.size());
+}
+
+// The same puzzle with rows and columns swapped.
+pze::Sudoku Transposed(const pze::Sudoku & puz) {
+  std::stringstream ss;
+  for (int r = 0; r < 9; r++) {
+    for (int c = 0; c < 9; c++) ss << puz.GetSymbols()[puz.GetCell(c*9 + r)];
+  }
+  pze::Sudoku out(ss);
+  for (int r = 0; r < 9; r++) {
+    for (int c = 0; c < 9; c++) out.SetStart(r*9 + c, puz.GetStart(c*9 + r));
+  }
+  return out;
+}
+
+// Canonical forms must not change under Shuffle() or transposition, but must change when
+// the start cells do.
+void CheckCanonicalForms(emp::Random & random) {
+  pze::SudokuCanonicalizer canon;
+  size_t num_bad = 0, num_tried = 0;
+  for (int i = 0; i < 100; i++) {
+    pze::Sudoku puz(random, 0.3);
+    const pze::CanonicalForm form = canon.Canonicalize(puz);
+    for (int k = 0; k < 4; k++) {
+      pze::Sudoku variant(puz);
+      variant.Shuffle(random);
+      if (k % 2) variant = Transposed(variant);
+      num_bad += !(canon.Canonicalize(variant) == form);
+      num_tried++;
+    }
+    pze::Sudoku changed(puz);
+    changed.SetStart(40, !puz.GetStart(40));
+    num_bad += (canon.Canonicalize(changed) == form);
+    num_tried++;
+  }
+  Report("canonical forms are invariant under shuffle and transpose", num_bad, num_tried);
+}
+
+// Puzzles written to a corpus file must read back unchanged, with or without a profile.
+void CheckCorpusRoundTrip(emp::Random & random) {
+  const std::string filename = (std::filesystem::temp_directory_path() / "pze_check.pzc").string();
+  std::vector<pze::Sudoku> puzzles;
+  for (int i = 0; i < 1000; i++) {
+    puzzles.push_back(RandomPuzzle(random, 0.4));
+    if (i % 2) puzzles.back().CalcProfile();
+  }
+  {
+    pze::CorpusWriter writer(filename);
+    for (const auto & puz : puzzles) writer.Write(puz);
+  }
+
+  size_t num_bad = 0;
+  pze::CorpusReader reader(filename);
+  if (reader.GetSize() != puzzles.size()) num_bad++;
+  for (size_t i = 0; i < std::min(reader.GetSize(), puzzles.size()); i++) {
+    const auto record = reader[i];
+    const pze::Sudoku & puz = puzzles[i];
+    const pze::Sudoku copy = record.ToSudoku();
+    bool same = copy.GetCells() == puz.GetCells() && copy.GetStartCells() == puz.GetStartCells()
+      && copy.GetSymbols() == puz.GetSymbols() && copy.GetGridID() == puz.GetGridID()
+      && record.HasProfile() == puz.IsEvaluated();
+    if (same && puz.IsEvaluated()) {
+      same = record.GetNumSteps() == puz.GetProfile().GetSize()
+        && record.IsSolved() == puz.GetProfile().IsSolved()
+        && record.GetSolutionCount() == puz.GetProfile().GetSolutionCount()
+        && (float) record.GetFitness() == (float) puz.GetFitness();
+    }
+    num_bad += !same;
+  }
+  reader.Close();
+  std::remove(filename.c_str());
+  Report("corpus records round-trip", num_bad, puzzles.size());
+}
+
+// Puzzles parsed without solving must say they lack a full grid, profile the same as
+// solved ones, and print no more than their start cells.
+void CheckStartOnlyPuzzles(emp::Random & random) {
+  std::string text;
+  for (int i = 0; i < 500; i++) {
+    const pze::Sudoku puz = RandomPuzzle(random, (i % 50 == 0) ? 1.0 : 0.3 + 0.3 * random.GetDouble());
+    for (int cell = 0; cell < 81; cell++) text += puz.GetCellSymbol(cell);
+    text += '\n';
+  }
+  std::vector<pze::Sudoku> start_only, solved;
+  pze::ParsePuzzles(text, start_only, false);
+  pze::ParsePuzzles(text, solved, true);
+
+  size_t num_bad = (start_only.size() != solved.size());
+  for (size_t i = 0; i < std::min(start_only.size(), solved.size()); i++) {
+    pze::Sudoku & puz = start_only[i];
+    bool all_given = true;
+    for (int cell = 0; cell < 81; cell++) all_given &= puz.GetStart(cell);
+    std::stringstream full, start;
+    puz.Print(true, full);
+    puz.Print(false, start);
+    num_bad += puz.HasFullGrid() != all_given || !solved[i].HasFullGrid()
+      || full.str() != start.str() || !SameProfile(puz.CalcProfile(), solved[i].CalcProfile());
+  }
+  Report("start-only puzzles are marked and handled", num_bad, start_only.size());
+}
+
+// Local search scores neighbors through SudokuBatch; every score must match a scalar
+// CalcProfile() of the same puzzle.
+void CheckLocalSearch(emp::Random & random) {
+  std::atomic<size_t> num_bad(0), num_tried(0);
+  pze::ThreadPool pool(2);
+  pze::SudokuLocalSearch search(pool, [&num_bad, &num_tried](pze::Sudoku * puz){
+      pze::Sudoku scalar(*puz);
+      scalar.SetStart(0, scalar.GetStart(0));     // Drop the batch result.
+      num_bad += scalar.CalcSimpleFitness() != puz->CalcSimpleFitness();
+      num_tried++;
+      return puz->CalcSimpleFitness();
+    });
+  pze::SudokuLocalSearch::Config config;
+  config.max_steps = 20;
+  config.tabu_tenure = 5;
+  for (int i = 0; i < 10; i++) search.Run(RandomPuzzle(random, 0.3 + 0.3 * random.GetDouble()), random, config);
+  Report("local search neighbor scores match scalar profiles", num_bad, num_tried);
+}
+
+// Migration between islands (even many small ones on a random topology) must never
+// replace an island's best organism.
+void CheckMigration(emp::Random & random) {
+  using Islands = pze::IslandModel<pze::Sudoku>;
+  auto fit_fun = [](pze::Sudoku * puz){ return puz->CalcSimpleFitness(); };
+  auto island_best = [&fit_fun](pze::Population<pze::Sudoku> & pop){
+    double best = fit_fun(&pop[0]);
+    for (int i = 1; i < pop.GetSize(); i++) best = std::max(best, fit_fun(&pop[i]));
+    return best;
+  };
+  size_t num_bad = 0, num_tried = 0;
+  for (int trial = 0; trial < 100; trial++) {
+    const auto topology = (trial % 2) ? Islands::Topology::RING : Islands::Topology::RANDOM;
+    Islands islands(RandomPuzzle(random, 0.5), 8, 3, random, fit_fun, topology, 2);
+    std::vector<double> best(islands.GetNumIslands());
+    for (int i = 0; i < islands.GetNumIslands(); i++) {
+      for (int id = 0; id < 3; id++) islands.GetIsland(i)[id].MutateStart(random, 0.1);
+      best[i] = island_best(islands.GetIsland(i));
+    }
+    islands.Migrate();
+    for (int i = 0; i < islands.GetNumIslands(); i++) {
+      num_bad += island_best(islands.GetIsland(i)) < best[i];
+      num_tried++;
+    }
+  }
+  Report("migration keeps every island's best organism", num_bad, num_tried);
+}
+
+// A direct lexicase selection, making the same random draws as LexicaseSelector.
+int NaiveLexicase(const pze::ObjectiveMatrix & matrix, pze::LexicaseSelector::Epsilon mode,
+                  double fixed_epsilon, emp::Random & random) {
+  const int num_orgs = matrix.GetNumOrgs();
+  std::vector<int> active;
+  std::vector<double> epsilon(matrix.GetNumObjectives(), 0.0);
+  for (int obj = 0; obj < matrix.GetNumObjectives(); obj++) {
+    std::vector<double> scores(matrix.GetObjective(obj), matrix.GetObjective(obj) + num_orgs);
+    if (mode == pze::LexicaseSelector::Epsilon::FIXED) epsilon[obj] = fixed_epsilon;
+    else if (mode == pze::LexicaseSelector::Epsilon::MAD) {
+      std::sort(scores.begin(), scores.end());
+      const double median = scores[num_orgs / 2];
+      for (double & score : scores) score = std::abs(score - median);
+      std::sort(scores.begin(), scores.end());
+      epsilon[obj] = scores[num_orgs / 2];
+    }
+    const double best = *std::max_element(matrix.GetObjective(obj), matrix.GetObjective(obj) + num_orgs);
+    for (int i = 0; i < num_orgs; i++) {
+      if (matrix.Get(i, obj) < best - epsilon[obj]) { active.push_back(obj); break; }
+    }
+  }
+  if (active.empty()) return (int) random.GetUInt(num_orgs);
+
+  for (int i = (int) active.size() - 1; i > 0; i--) std::swap(active[i], active[random.GetUInt(i + 1)]);
+  std::vector<int> candidates(num_orgs);
+  for (int i = 0; i < num_orgs; i++) candidates[i] = i;
+  for (int obj : active) {
+    if (candidates.size() <= 1) break;
+    double best = -INFINITY;
+    for (int id : candidates) best = std::max(best, matrix.Get(id, obj));
+    std::erase_if(candidates, [&](int id){ return matrix.Get(id, obj) < best - epsilon[obj]; });
+  }
+  return candidates[candidates.size() > 1 ? random.GetUInt(candidates.size()) : 0];
+}
+
+// LexicaseSelector (with its cached elite sets) must pick exactly what the direct version does.
+void CheckLexicase(emp::Random & random) {
+  using Epsilon = pze::LexicaseSelector::Epsilon;
+  size_t num_bad = 0, num_tried = 0;
+  for (int trial = 0; trial < 30; trial++) {
+    const int num_orgs = 1 + (int) random.GetUInt(300);
+    const int num_objs = 1 + (int) random.GetUInt(20);
+    pze::ObjectiveMatrix matrix(num_orgs, num_objs);
+    for (int i = 0; i < num_orgs; i++) {
+      for (int j = 0; j < num_objs; j++) {
+        const double score = (j % 5 == 4) ? 3.0 : (double) random.GetUInt(1 + j % 4 * 3);
+        matrix.Set(i, j, score + ((trial % 2) ? random.GetDouble() : 0.0));
+      }
+    }
+    for (Epsilon mode : { Epsilon::NONE, Epsilon::FIXED, Epsilon::MAD }) {
+      pze::LexicaseSelector selector;
+      selector.Setup(matrix, mode, 0.5);
+      const int seed = 1 + (int) random.GetUInt(1000000);
+      emp::Random fast_random(seed), naive_random(seed);
+      for (int s = 0; s < 100; s++) {
+        num_bad += selector.Select(fast_random) != NaiveLexicase(matrix, mode, 0.5, naive_random);
+        num_tried++;
+      }
+    }
+  }
+  Report("lexicase selection matches a direct implementation", num_bad, num_tried);
+}
+
+int main()
+{
+  emp::Random random(1);
+  CheckDirtyScans(random);
+  CheckPlaneState(random);
+  CheckPlaneLadder(random);
+  CheckRegionOverlap(random);
+  CheckBatchProfiles(random);
+  CheckBatchGrading(random);
+  CheckCanonicalForms(random);
+  CheckCorpusRoundTrip(random);
+  CheckStartOnlyPuzzles(random);
+  CheckLocalSearch(random);
+  CheckMigration(random);
+  CheckLexicase(random);
+
+  if (num_failed) std::cout << num_failed << " check(s) failed." << std::endl;
+  return num_failed ? 1 : 0;
+}
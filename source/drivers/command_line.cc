@@ -4,51 +4,454 @@
 //
 //  Main file to run the command-line version of PuzzleEngine
 
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
 #include <iostream>
 #include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../BoundedQueue.h"
+#include "../IslandModel.h"
+#include "../Lexicase.h"
+#include "../LocalSearch.h"
+#include "../Population.h"
+#include "../ProfileCache.h"
 #include "../Sudoku.h"
-//#include "Evolve/Population.h"
+#include "../SudokuBatch.h"
+#include "../SudokuParse.h"
+#include "../SolveStats.h"
+#include "../SteadyState.h"
+#include "../ThreadPool.h"
 
-void DoRun(const pze::Sudoku & puz, emp::Random & random,
+// Shared by every mode (see main()), so unchanged puzzles are never profiled twice.
+pze::ProfileCache profile_cache(1 << 16);
+
+// Report how the profile cache has done since its counters were last reset.
+void PrintCacheStats(std::ostream & out) {
+  out << "Profile cache: " << profile_cache.GetHits() << " hits, "
+      << profile_cache.GetMisses() << " misses ("
+      << 100.0 * profile_cache.GetHitRate() << "% hit rate)." << std::endl;
+}
+
+void DoRun(const pze::Sudoku & puz, emp::Random & random, pze::ThreadPool & pool,
            int pop_size, int num_updates, double mut_rate, std::ostream & out_log)
 {
-  //out_log << pop_size 
-  //        << ", " << num_updates
-  //        << ", " << mut_rate;
-  //
-  //emp::EA::Population<pze::Sudoku> pop;
-  //pop.Insert(puz, pop_size);
+  profile_cache.ResetStats();
+  out_log << pop_size
+          << ", " << num_updates
+          << ", " << mut_rate;
 
-  //for (int update = 0; update < num_updates; update++) {
-  //  for (int i = 1; i < pop.GetSize(); i++) {
-  //    pop[i].MutateStart(random, mut_rate);
-  //  }
+  pze::Population<pze::Sudoku> pop;
+  pop.Insert(puz, pop_size);
 
-  //  pop.EliteSelect( [](pze::Sudoku* s){return s->CalcSimpleFitness();}, 1, 1);
-  //  pop.TournamentSelect( [](pze::Sudoku* s){return s->CalcSimpleFitness();},
-  //                        4, random, pop_size-1);
-  //  std::cout << update << " : " << pop[0].CalcSimpleFitness() << std::endl;
-  //  pop.Update();
-  //}
+  // With PZE_STATS, dump the solver counters for each generation.
+  if (pze::solve_stats::IsEnabled()) {
+    pze::solve_stats::Reset();
+    pze::SolveCounters::PrintHeader(std::cerr);
+  }
 
-  //out_log << ", " << pop[0].CalcSimpleFitness()
-  //        << std::endl;
-  //pop[0].Print();
-  //pop[0].CalcProfile().Print();
-  
+  for (int update = 0; update < num_updates; update++) {
+    // Mutate serially so the random number sequence doesn't depend on thread count.
+    for (int i = 1; i < pop.GetSize(); i++) {
+      pop[i].MutateStart(random, mut_rate);
+    }
+
+    // Calculate all profiles in parallel batches; selection only reads the cached fitness.
+    pze::EvaluatePopulationBatched(pop, pool);
+
+    pop.EliteSelect( [](pze::Sudoku* s){return s->CalcSimpleFitness();}, 1, 1);
+    pop.TournamentSelect( [](pze::Sudoku* s){return s->CalcSimpleFitness();},
+                          4, random, pop_size-1);
+    std::cout << update << " : " << pop[0].CalcSimpleFitness() << std::endl;
+    if (pze::solve_stats::IsEnabled()) {
+      pze::solve_stats::Snapshot().Print(std::to_string(update), std::cerr);
+      pze::solve_stats::Reset();
+    }
+    pop.Update();
+  }
+
+  out_log << ", " << pop[0].CalcSimpleFitness()
+          << std::endl;
+  PrintCacheStats(std::cout);
+  pop[0].Print();
+  pop[0].CalcProfile().Print();
+}
+
+// Like DoRun(), but pick parents by (epsilon-)lexicase selection over the solving-profile
+// objectives, keeping the single best puzzle by simple fitness.
+void DoLexicaseRun(const pze::Sudoku & puz, emp::Random & random, pze::ThreadPool & pool,
+                   int pop_size, int num_updates, double mut_rate,
+                   pze::LexicaseSelector::Epsilon epsilon, std::ostream & out_log)
+{
+  profile_cache.ResetStats();
+  out_log << pop_size
+          << ", " << num_updates
+          << ", " << mut_rate;
+
+  pze::Population<pze::Sudoku> pop;
+  pop.Insert(puz, pop_size);
+  pze::LexicaseSelector selector;
+
+  for (int update = 0; update < num_updates; update++) {
+    for (int i = 1; i < pop.GetSize(); i++) {
+      pop[i].MutateStart(random, mut_rate);
+    }
+    pze::EvaluatePopulationBatched(pop, pool);
+
+    const pze::ObjectiveMatrix objectives = pze::BuildProfileObjectives(pop);
+    selector.Setup(objectives, epsilon);
+    pop.EliteSelect( [](pze::Sudoku* s){return s->CalcSimpleFitness();}, 1, 1);
+    pop.SelectWith(selector, random, pop_size-1);
+    std::cout << update << " : " << pop[0].CalcSimpleFitness() << std::endl;
+    pop.Update();
+  }
+
+  out_log << ", " << pop[0].CalcSimpleFitness()
+          << std::endl;
+  PrintCacheStats(std::cout);
+  pop[0].Print();
+  pop[0].CalcProfile().Print();
+}
+
+// Evolve puzzles on several islands at once (one pool task per island between migrations),
+// with the same generation as DoRun() on each island.
+void DoIslandRun(const pze::Sudoku & puz, emp::Random & random, pze::ThreadPool & pool,
+                 int num_islands, int island_size, int num_updates, int migrate_interval,
+                 pze::IslandModel<pze::Sudoku>::Topology topology, double mut_rate,
+                 std::ostream & out_log)
+{
+  profile_cache.ResetStats();
+  out_log << num_islands
+          << ", " << island_size
+          << ", " << num_updates
+          << ", " << migrate_interval
+          << ", " << mut_rate;
+
+  auto fit_fun = [](pze::Sudoku* s){ return s->CalcSimpleFitness(); };
+  pze::IslandModel<pze::Sudoku> islands(puz, num_islands, island_size, random, fit_fun, topology, 2);
+
+  auto step = [&fit_fun, mut_rate](pze::Population<pze::Sudoku> & pop, emp::Random & island_random) {
+    for (int i = 1; i < pop.GetSize(); i++) pop[i].MutateStart(island_random, mut_rate);
+    pze::EvaluatePopulationBatched(pop);      // Already on a pool thread; batch serially.
+    pop.EliteSelect(fit_fun, 1, 1);
+    pop.TournamentSelect(fit_fun, 4, island_random, pop.GetSize()-1);
+    pop.Update();
+  };
+
+  while (islands.GetGeneration() < num_updates) {
+    islands.Run(std::min(migrate_interval, num_updates - islands.GetGeneration()), migrate_interval, pool, step);
+    std::cout << islands.GetGeneration() << " : " << islands.GetBest().CalcSimpleFitness() << std::endl;
+  }
+
+  pze::Sudoku best = islands.GetBest();
+  out_log << ", " << best.CalcSimpleFitness()
+          << std::endl;
+  PrintCacheStats(std::cout);
+  best.Print();
+  best.CalcProfile().Print();
+}
+
+// Evolve puzzles without generations: every pool thread breeds, evaluates, and inserts
+// children into one shared population, num_evals children in all.
+void DoSteadyRun(const pze::Sudoku & puz, emp::Random & random, pze::ThreadPool & pool,
+                 int pop_size, size_t num_evals, pze::SteadyStatePopulation<pze::Sudoku>::Replace replace,
+                 double mut_rate, std::ostream & out_log)
+{
+  profile_cache.ResetStats();
+  out_log << pop_size
+          << ", " << num_evals
+          << ", " << mut_rate;
+
+  pze::SteadyStatePopulation<pze::Sudoku> pop(
+    [](pze::Sudoku* s){ return s->CalcSimpleFitness(); },
+    [mut_rate](pze::Sudoku & s, emp::Random & r){ s.MutateStart(r, mut_rate); },
+    4, replace);
+  pop.Insert(puz, pop_size);
+
+  // Report progress once per population's worth of evaluations, from inside the run.
+  const auto start_time = std::chrono::steady_clock::now();
+  pop.Run(num_evals, random, pool, pop_size, [start_time](size_t done, double best_fit){
+      const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+      std::cout << done << " : " << best_fit
+                << " (" << (seconds > 0.0 ? done / seconds : 0.0) << " evals/s)" << std::endl;
+    });
+
+  pze::Sudoku best = pop[pop.GetBestID()];
+  out_log << ", " << best.CalcSimpleFitness()
+          << std::endl;
+  PrintCacheStats(std::cout);
+  best.Print();
+  best.CalcProfile().Print();
+}
+
+void DoLocalSearch(const pze::Sudoku & puz, emp::Random & random, pze::ThreadPool & pool,
+                   const pze::SudokuLocalSearch::Config & config, std::ostream & out_log)
+{
+  profile_cache.ResetStats();
+  pze::SudokuLocalSearch search(pool);
+  pze::Sudoku best = search.Run(puz, random, config);
+
+  const auto & stats = search.GetStats();
+  std::cout << stats.steps << " moves, " << stats.improvements << " improvements, "
+            << stats.restarts << " restarts (" << stats.GetEvalsPerSec() << " evals/s)" << std::endl;
+
+  out_log << config.max_steps
+          << ", " << config.tabu_tenure
+          << ", " << config.max_restarts
+          << ", " << best.CalcSimpleFitness()
+          << std::endl;
+  PrintCacheStats(std::cout);
+  best.Print();
+  best.CalcProfile().Print();
+}
+
+// Batch grading: read one-line puzzles, calculate their profiles, and write a line of
+// results for each, in input order.  The work is a pipeline of stages joined by bounded
+// queues (so no stage can run far ahead and memory stays flat):
+//   reader -> text blocks -> parser -> puzzle groups -> solvers (one per thread) -> writer
+// The reader and writer overlap file I/O with solving; each solver evaluates its group with
+// a SudokuBatch and formats the results, and the writer puts the groups back in order.
+
+struct TextBlock {
+  size_t id;
+  std::string text;         // Whole lines only.
+};
+
+struct PuzzleGroup {
+  size_t id;
+  std::vector<pze::Sudoku> puzzles;
+};
+
+struct ResultGroup {
+  size_t id;
+  size_t count;
+  std::string text;
+};
+
+void FormatResult(pze::Sudoku & puz, std::ostream & out) {
+  for (int i = 0; i < 81; i++) out << (puz.GetStart(i) ? puz.GetSymbols()[puz.GetCell(i)] : '.');
+  const pze::PuzzleProfile & profile = puz.CalcProfile();
+  int total_moves = 0;
+  int max_level = 0;
+  for (int i = 0; i < profile.GetSize(); i++) {
+    total_moves += profile.GetCount(i);
+    max_level = std::max(max_level, profile.GetLevel(i));
+  }
+  out << ", " << profile.IsSolved()
+      << ", " << profile.GetSolutionCount()
+      << ", " << profile.GetSize()
+      << ", " << total_moves
+      << ", " << max_level
+      << ", " << puz.GetFitness()
+      << '\n';
 }
 
-int main()
+int RunBatch(const std::string & in_name, const std::string & out_name, size_t num_solvers)
 {
+  static constexpr size_t BLOCK_SIZE = 64 * 1024;    // Bytes read at a time (~800 puzzles).
+
+  std::ifstream in_file;
+  std::ofstream out_file;
+  if (in_name != "-") {
+    in_file.open(in_name, std::ios::binary);
+    if (!in_file) { std::cerr << "Unable to open '" << in_name << "'." << std::endl; return 1; }
+  }
+  if (out_name != "-") {
+    out_file.open(out_name, std::ios::binary);
+    if (!out_file) { std::cerr << "Unable to open '" << out_name << "'." << std::endl; return 1; }
+  }
+  std::istream & in = (in_name == "-") ? std::cin : in_file;
+  std::ostream & out = (out_name == "-") ? std::cout : out_file;
+
+  pze::BoundedQueue<TextBlock> text_queue(4);
+  pze::BoundedQueue<PuzzleGroup> puzzle_queue(2 * num_solvers);
+  pze::BoundedQueue<ResultGroup> result_queue(2 * num_solvers);
+  size_t bad_lines = 0;
+
+  profile_cache.ResetStats();
+  const auto start_time = std::chrono::steady_clock::now();
+
+  // Read fixed-size blocks, holding back any partial line for the next one.
+  std::thread reader([&in, &text_queue](){
+      std::string carry;
+      std::vector<char> buffer(BLOCK_SIZE);
+      size_t next_id = 0;
+      while (in) {
+        in.read(buffer.data(), buffer.size());
+        carry.append(buffer.data(), (size_t) in.gcount());
+        const size_t last_newline = carry.rfind('\n');
+        if (last_newline == std::string::npos) continue;
+        std::string rest = carry.substr(last_newline + 1);
+        carry.resize(last_newline + 1);
+        text_queue.Push(TextBlock{next_id++, std::move(carry)});
+        carry = std::move(rest);
+      }
+      if (!carry.empty()) text_queue.Push(TextBlock{next_id++, std::move(carry)});
+      text_queue.Close();
+    });
+
+  // Turn each block into a group of puzzles (blank cells are not needed for grading).
+  std::thread parser([&text_queue, &puzzle_queue, &bad_lines](){
+      TextBlock block;
+      while (text_queue.Pop(block)) {
+        PuzzleGroup group{block.id, {}};
+        pze::ParsePuzzles(block.text, group.puzzles, false, &bad_lines);
+        puzzle_queue.Push(std::move(group));
+      }
+      puzzle_queue.Close();
+    });
+
+  std::vector<std::thread> solvers;
+  for (size_t t = 0; t < num_solvers; t++) {
+    solvers.emplace_back([&puzzle_queue, &result_queue](){
+        PuzzleGroup group;
+        std::vector<pze::Sudoku*> todo;
+        pze::SudokuBatch batch;
+        while (puzzle_queue.Pop(group)) {
+          todo.clear();
+          for (auto & puz : group.puzzles) todo.push_back(&puz);
+          batch.Evaluate(todo.data(), todo.size());
+
+          std::stringstream text;
+          for (auto & puz : group.puzzles) FormatResult(puz, text);
+          result_queue.Push(ResultGroup{group.id, group.puzzles.size(), text.str()});
+        }
+      });
+  }
+
+  // Close the results once every solver is done.
+  std::thread closer([&solvers, &result_queue](){
+      for (auto & solver : solvers) solver.join();
+      result_queue.Close();
+    });
+
+  // Write results in input order, holding any that arrive early.
+  out << "puzzle, solved, solutions, steps, moves, max_level, fitness\n";
+  std::map<size_t, ResultGroup> waiting;
+  size_t next_id = 0;
+  size_t num_puzzles = 0;
+  ResultGroup result;
+  while (result_queue.Pop(result)) {
+    const size_t id = result.id;
+    waiting.emplace(id, std::move(result));
+    for (auto it = waiting.find(next_id); it != waiting.end(); it = waiting.find(++next_id)) {
+      out << it->second.text;
+      num_puzzles += it->second.count;
+      waiting.erase(it);
+    }
+  }
+  out.flush();
+
+  reader.join();
+  parser.join();
+  closer.join();
+
+  const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+  std::cerr << "Graded " << num_puzzles << " puzzles (" << bad_lines << " bad lines) in "
+            << seconds << " s with " << num_solvers << " solver threads: "
+            << (seconds > 0.0 ? num_puzzles / seconds : 0.0) << " puzzles/s." << std::endl;
+  PrintCacheStats(std::cerr);
+  if (pze::solve_stats::IsEnabled()) {
+    pze::SolveCounters::PrintHeader(std::cerr);
+    pze::solve_stats::Snapshot().Print("batch", std::cerr);
+  }
+  return 0;
+}
+
+int main(int argc, char * argv[])
+{
+  pze::Sudoku::SetProfileCache(&profile_cache);
+
+  // PuzzleEngine batch <input|-> [output|-] [threads]
+  if (argc >= 3 && std::string(argv[1]) == "batch") {
+    const std::string out_name = (argc >= 4) ? argv[3] : "-";
+    size_t num_solvers = (argc >= 5) ? (size_t) std::atoi(argv[4]) : std::thread::hardware_concurrency();
+    if (num_solvers == 0) num_solvers = 1;
+    return RunBatch(argv[2], out_name, num_solvers);
+  }
+
+  // PuzzleEngine run <puzzle> [pop_size] [updates] [mut_rate] [seed]
+  if (argc >= 3 && std::string(argv[1]) == "run") {
+    pze::Sudoku puz(argv[2]);
+    const int pop_size = (argc >= 4) ? std::max(std::atoi(argv[3]), 2) : 1000;
+    const int num_updates = (argc >= 5) ? std::atoi(argv[4]) : 100;
+    const double mut_rate = (argc >= 6) ? std::atof(argv[5]) : 0.015;
+    emp::Random random((argc >= 7) ? std::atoi(argv[6]) : 1);
+    pze::ThreadPool pool;
+    DoRun(puz, random, pool, pop_size, num_updates, mut_rate, std::cout);
+    return 0;
+  }
+
+  // PuzzleEngine islands <puzzle> [islands] [island_size] [updates] [interval] [ring|random] [seed]
+  if (argc >= 3 && std::string(argv[1]) == "islands") {
+    pze::Sudoku puz(argv[2]);
+    const int num_islands = (argc >= 4) ? std::atoi(argv[3]) : 4;
+    const int island_size = (argc >= 5) ? std::atoi(argv[4]) : 250;
+    const int num_updates = (argc >= 6) ? std::atoi(argv[5]) : 100;
+    const int interval = (argc >= 7) ? std::atoi(argv[6]) : 10;
+    const auto topology = (argc >= 8 && std::string(argv[7]) == "random")
+      ? pze::IslandModel<pze::Sudoku>::Topology::RANDOM : pze::IslandModel<pze::Sudoku>::Topology::RING;
+    emp::Random random((argc >= 9) ? std::atoi(argv[8]) : 1);
+    pze::ThreadPool pool;
+    DoIslandRun(puz, random, pool, num_islands, island_size, num_updates, std::max(interval, 1),
+                topology, 0.015, std::cout);
+    return 0;
+  }
+
+  // PuzzleEngine lexicase <puzzle> [pop_size] [updates] [none|mad] [seed]
+  if (argc >= 3 && std::string(argv[1]) == "lexicase") {
+    pze::Sudoku puz(argv[2]);
+    const int pop_size = (argc >= 4) ? std::max(std::atoi(argv[3]), 2) : 1000;
+    const int num_updates = (argc >= 5) ? std::atoi(argv[4]) : 100;
+    const auto epsilon = (argc >= 6 && std::string(argv[5]) == "mad")
+      ? pze::LexicaseSelector::Epsilon::MAD : pze::LexicaseSelector::Epsilon::NONE;
+    emp::Random random((argc >= 7) ? std::atoi(argv[6]) : 1);
+    pze::ThreadPool pool;
+    DoLexicaseRun(puz, random, pool, pop_size, num_updates, 0.015, epsilon, std::cout);
+    return 0;
+  }
+
+  // PuzzleEngine steady <puzzle> [pop_size] [evaluations] [worst|tournament] [seed]
+  if (argc >= 3 && std::string(argv[1]) == "steady") {
+    pze::Sudoku puz(argv[2]);
+    const int pop_size = (argc >= 4) ? std::max(std::atoi(argv[3]), 1) : 1000;
+    const size_t num_evals = (argc >= 5) ? (size_t) std::atoll(argv[4]) : 100000;
+    const auto replace = (argc >= 6 && std::string(argv[5]) == "tournament")
+      ? pze::SteadyStatePopulation<pze::Sudoku>::Replace::TOURNAMENT
+      : pze::SteadyStatePopulation<pze::Sudoku>::Replace::WORST;
+    emp::Random random((argc >= 7) ? std::atoi(argv[6]) : 1);
+    pze::ThreadPool pool;
+    DoSteadyRun(puz, random, pool, pop_size, num_evals, replace, 0.015, std::cout);
+    return 0;
+  }
+
+  // PuzzleEngine localsearch <puzzle> [steps] [tabu_tenure] [restarts] [seed]
+  if (argc >= 3 && std::string(argv[1]) == "localsearch") {
+    pze::Sudoku puz(argv[2]);
+    pze::SudokuLocalSearch::Config config;
+    if (argc >= 4) config.max_steps = std::atoi(argv[3]);
+    if (argc >= 5) config.tabu_tenure = std::max(std::atoi(argv[4]), 0);
+    if (argc >= 6) config.max_restarts = std::max(std::atoi(argv[5]), 0);
+    emp::Random random((argc >= 7) ? std::atoi(argv[6]) : 1);
+    pze::ThreadPool pool;
+    DoLocalSearch(puz, random, pool, config, std::cout);
+    return 0;
+  }
+
   // pze::Sudoku puz("puzzles/blank.puz");
   // pze::Sudoku puz("puzzles/test2.puz");
     //pze::Sudoku puz("puzzles/wikipedia.puz");
   // pze::Sudoku puz("puzzles/letters.puz");
     //emp::Random random;
+    //pze::ThreadPool pool;
 
   //std::ofstream out("out.log");
 
-  //DoRun(puz, random, 1000, 100, 0.015, out);
+  //DoRun(puz, random, pool, 1000, 100, 0.015, out);
 
   //exit(0);
 
@@ -57,7 +460,7 @@ int main()
   //
   //for (double m : mut_rates) {
   //  for (int r=0; r < reps; r++) {
-  //    DoRun(puz, random, 100, 1000, m, out);
+  //    DoRun(puz, random, pool, 100, 1000, m, out);
   //  }
   //}
   //
@@ -97,6 +500,7 @@ int main()
   state.Print();
   auto moves = state.Solve_FindLimitedCells();
   std::cout << "moves = " << moves.size() << std::endl;
+  state.Move(moves);
   state.OK();
   state.Print();
 }
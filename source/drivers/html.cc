@@ -2,13 +2,17 @@
 #include "tools/Random.h"
 #include "web/web.h"
 
+#include "../Population.h"
 #include "../Sudoku.h"
+#include "../ThreadPool.h"
 
 namespace UI = emp::web;
 
 UI::Document doc("emp_base");
 emp::Random rng;
 emp::EA::Population<pze::Sudoku> pop;
+pze::ProfileCache profile_cache(1 << 14);   // Reuse profiles of unchanged puzzles.
+pze::ThreadPool pool;                       // Runs tasks inline in the web build.
 
 const int pop_size = 1000;
 const double mut_rate = 0.015;
@@ -43,6 +47,9 @@ void DoRunStep() {
     pop[i].MutateStart(rng, mut_rate);
   }
 
+  // Evaluate the whole population before selection reads any fitness values.
+  pze::EvaluatePopulation(pop, pool);
+
   // Do a round of selection.
   pop.EliteSelect( [](pze::Sudoku* s){return s->CalcSimpleFitness();}, 1, 1);
   pop.TournamentSelect( [](pze::Sudoku* s){return s->CalcSimpleFitness();},
@@ -72,6 +79,7 @@ void DoRunStep() {
 extern "C" int main()
 {
   UI::Initialize();
+  pze::Sudoku::SetProfileCache(&profile_cache);
 
   auto & anim = doc.AddAnimation("run", DoRunStep);
 